@@ -0,0 +1,378 @@
+#include "agent.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "tuning.h"
+
+namespace Agent
+{
+	static_assert(AgentLink::maxBirds == World::maxPlayers, "Every bird has to fit in a published state");
+
+	typedef std::chrono::steady_clock Clock;
+
+	static void AddLatency(Stats& stats, const AgentLink::Action& action);
+	static bool WaitForAction(AgentLink::Link& link, uint64_t tick, Clock::time_point deadline, World::Input& input, Stats& stats);
+	static bool IsHovering(const AgentLink::State& state);
+	static AgentLink::Action Answer(const AgentLink::State& state);
+
+	void Publish(AgentLink::Link& link, const World::World& world)
+	{
+		AgentLink::State state = {};
+
+		state.tick = world.tick;
+		state.seed = world.seed;
+		state.deltaT = world.deltaT;
+		state.score = world.score;
+		state.playerCount = static_cast<uint8_t>(world.playerCount);
+		state.hasLost = world.hasLost ? 1 : 0;
+		state.birdX = world.birds[0].position.x;
+
+		for (int i = 0; i < world.playerCount; i++)
+		{
+			state.birds[i].y = world.birds[i].position.y;
+			state.birds[i].velocity = world.birds[i].velocity;
+			state.birds[i].isOn = world.birds[i].isOn ? 1 : 0;
+		}
+
+		// bottom is the upper pipe
+		state.obstacleX = world.obstacle.bottom.x;
+		state.obstacleWidth = world.obstacle.width;
+		state.obstacleVelocity = world.obstacle.velocity;
+		state.gapTop = world.obstacle.bottom.y + world.obstacle.height;
+		state.gapBottom = world.obstacle.top.y;
+
+		// Stamped last, so the round trip doesn't count the time spent filling it in
+		state.publishTime = AgentLink::GetTime();
+
+		AgentLink::Publish(link, state);
+	}
+
+	void AddLatency(Stats& stats, const AgentLink::Action& action)
+	{
+		uint64_t latency = AgentLink::GetTime() - action.stateTime;
+
+		stats.actions++;
+		stats.totalLatency += static_cast<double>(latency);
+		stats.worstLatency = std::max(stats.worstLatency, latency);
+	}
+
+	World::Input TakeInput(AgentLink::Link& link, const World::World& world, Stats& stats)
+	{
+		World::Input input = 0;
+		AgentLink::Action action;
+
+		while (AgentLink::TakeAction(link, world.tick, action))
+		{
+			input |= action.input;
+			AddLatency(stats, action);
+		}
+
+		return input;
+	}
+
+	bool WaitForAction(AgentLink::Link& link, uint64_t tick, Clock::time_point deadline, World::Input& input, Stats& stats)
+	{
+		// Until the agent answers the state of this tick; answers to older ones still count as they come
+		AgentLink::Action action;
+
+		while (true)
+		{
+			if (AgentLink::TakeAction(link, tick, action))
+			{
+				input |= action.input;
+				AddLatency(stats, action);
+
+				if (action.tick == tick)
+				{
+					return true;
+				}
+
+				continue;
+			}
+
+			if (Clock::now() >= deadline)
+			{
+				return false;
+			}
+
+			std::this_thread::yield();
+		}
+	}
+
+	int RunHost(const HostConfig& config)
+	{
+		if (config.rounds < 1 || config.playerCount < 1 || config.playerCount > World::maxPlayers || !(config.deltaT > 0.0f) || !(config.maxTime > 0.0f)
+			|| !(config.timeoutMs > 0.0f))
+		{
+			std::cerr << "rounds, dt, max time and timeout must be positive and players 1 to " << World::maxPlayers << "\n";
+			return 1;
+		}
+
+		AgentLink::Link link;
+
+		if (!AgentLink::Create(link, config.name))
+		{
+			std::cerr << "could not create the agent link " << config.name << "\n";
+			return 1;
+		}
+
+		World::World world;
+		World::StepFunction step = World::GetStep(config.playerCount);
+		Stats stats;
+
+		const Clock::duration tickTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(config.deltaT));
+		const Clock::duration timeout = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(config.timeoutMs));
+
+		unsigned long long ticks = 0;
+		unsigned long long timeouts = 0;
+		long long totalScore = 0;
+
+		Clock::time_point start = Clock::now();
+		Clock::time_point next = start;
+
+		for (int round = 0; round < config.rounds; round++)
+		{
+			World::Reset(world, config.playerCount, config.seed + static_cast<uint64_t>(round));
+			world.deltaT = config.deltaT;
+
+			// The agent's answer to the end of the last round would hold back this one's from tick 0
+			AgentLink::DropActions(link);
+			Publish(link, world);
+
+			while (!world.hasLost && world.timeAlive < config.maxTime)
+			{
+				World::Input input = 0;
+
+				if (config.isLockstep)
+				{
+					if (!WaitForAction(link, world.tick, Clock::now() + timeout, input, stats))
+					{
+						timeouts++;
+					}
+				}
+				else
+				{
+					next += tickTime;
+					std::this_thread::sleep_until(next);
+
+					input = TakeInput(link, world, stats);
+				}
+
+				step(world, input);
+				ticks++;
+
+				Publish(link, world);
+			}
+
+			totalScore += world.score;
+		}
+
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		AgentLink::Close(link);
+
+		std::cout << config.rounds << " rounds, score " << static_cast<double>(totalScore) / config.rounds << " on average, " << ticks << " ticks in " << seconds << " s\n";
+		std::cout << stats.actions << " actions taken, round trip from state to action " << stats.totalLatency / std::max<unsigned long long>(1, stats.actions) / 1000.0
+			<< " us on average, " << stats.worstLatency / 1000.0 << " us at worst";
+
+		if (config.isLockstep)
+		{
+			std::cout << ", " << timeouts << " ticks timed out";
+		}
+
+		std::cout << "\n";
+
+		return 0;
+	}
+
+	bool IsHovering(const AgentLink::State& state)
+	{
+		// Flap once the next tick would take the bird below the lowest it can be in the gap
+		const Tuning::Tuning& tuning = Tuning::Get();
+		const AgentLink::Bird& bird = state.birds[0];
+
+		float nextY = bird.y - (bird.velocity - tuning.gravity * state.deltaT) * state.deltaT;
+
+		return nextY > state.gapBottom - tuning.birdRadius;
+	}
+
+	AgentLink::Action Answer(const AgentLink::State& state)
+	{
+		AgentLink::Action action;
+		action.tick = state.tick;
+		action.epoch = state.epoch;
+		action.stateTime = state.publishTime;
+		action.input = !state.hasLost && IsHovering(state) ? 1 : 0;
+
+		return action;
+	}
+
+	int RunBot(const BotConfig& config)
+	{
+		const Clock::duration idleTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(config.idleSeconds));
+
+		// The game may start after the agent
+		AgentLink::Link link;
+		Clock::time_point waitStart = Clock::now();
+
+		while (!AgentLink::Open(link, config.name))
+		{
+			if (Clock::now() - waitStart >= idleTime)
+			{
+				std::cerr << "no game is hosting the agent link " << config.name << "\n";
+				return 1;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		unsigned long long states = 0;
+		unsigned long long skipped = 0;
+		unsigned long long flaps = 0;
+		uint64_t lastTick = 0;
+		uint64_t lastEpoch = 0;
+
+		Clock::time_point lastState = Clock::now();
+		AgentLink::State state;
+
+		while (Clock::now() - lastState < idleTime)
+		{
+			if (!AgentLink::ReadNewest(link, state))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			lastState = Clock::now();
+
+			// Ticks the host went through between two reads; a restart starts the count over
+			if (states > 0 && state.epoch == lastEpoch && state.tick > lastTick + 1)
+			{
+				skipped += state.tick - lastTick - 1;
+			}
+
+			states++;
+			lastTick = state.tick;
+			lastEpoch = state.epoch;
+
+			AgentLink::Action action = Answer(state);
+
+			flaps += action.input;
+			AgentLink::Send(link, action);
+		}
+
+		AgentLink::Close(link);
+
+		std::cout << states << " states read, " << skipped << " ticks skipped, " << flaps << " flaps sent\n";
+		return 0;
+	}
+
+	int RunCheck(const std::string& name)
+	{
+		const int ticksPerRound = 600;
+		const Clock::duration timeout = std::chrono::milliseconds(100);
+
+		AgentLink::Link host;
+		AgentLink::Link agent;
+
+		if (!AgentLink::Create(host, name) || !AgentLink::Open(agent, name))
+		{
+			std::cerr << "could not set up the agent link " << name << "\n";
+			AgentLink::Close(host);
+			return 1;
+		}
+
+		int failures = 0;
+
+		// The agent answers the last state of a round, the game restarts, and a second answer to that state comes late
+		World::World world;
+		World::Reset(world, 1, 1);
+		Publish(host, world);
+
+		AgentLink::State state;
+		AgentLink::ReadNewest(agent, state);
+
+		AgentLink::Action stale = Answer(state);
+		stale.tick = 2400;
+
+		AgentLink::Send(agent, stale);
+		AgentLink::DropActions(host);
+		AgentLink::Send(agent, stale);
+
+		Publish(host, world);
+		AgentLink::ReadNewest(agent, state);
+
+		AgentLink::Action flap = Answer(state);
+		flap.input = 1;
+		AgentLink::Send(agent, flap);
+
+		AgentLink::Action taken;
+
+		if (!AgentLink::TakeAction(host, 0, taken) || taken.input != 1)
+		{
+			std::cout << "an answer from before a restart held back the first one after it\n";
+			failures++;
+		}
+
+		// Two lockstep rounds against an agent on another thread; the second only works if the first's end is dropped
+		std::atomic<bool> isDone(false);
+
+		std::thread bot([&agent, &isDone]()
+		{
+			AgentLink::State newest;
+
+			while (!isDone.load())
+			{
+				if (AgentLink::ReadNewest(agent, newest))
+				{
+					AgentLink::Send(agent, Answer(newest));
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		Stats stats;
+
+		for (int round = 0; round < 2; round++)
+		{
+			World::Reset(world, 1, static_cast<uint64_t>(round) + 1);
+
+			AgentLink::DropActions(host);
+			Publish(host, world);
+
+			bool isAnswered = true;
+
+			while (isAnswered && !world.hasLost && world.tick < static_cast<uint64_t>(ticksPerRound))
+			{
+				World::Input input = 0;
+				isAnswered = WaitForAction(host, world.tick, Clock::now() + timeout, input, stats);
+
+				World::Step<1>(world, input);
+				Publish(host, world);
+			}
+
+			std::cout << "round " << round + 1 << ": " << world.tick << " ticks, " << (isAnswered ? "every one answered" : "an answer timed out") << "\n";
+
+			if (!isAnswered)
+			{
+				failures++;
+			}
+		}
+
+		isDone = true;
+		bot.join();
+
+		AgentLink::Close(agent);
+		AgentLink::Close(host);
+
+		std::cout << (failures == 0 ? "agent link ok" : "agent link FAILED") << "\n";
+		return failures == 0 ? 0 : 1;
+	}
+}
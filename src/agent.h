@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "agent_link.h"
+#include "world.h"
+
+// Lets an outside process play through AgentLink: the world goes out after every tick, inputs come back before the next
+namespace Agent
+{
+	struct Stats
+	{
+		unsigned long long actions = 0;
+
+		// From a state being published to the game taking the action that answers it, in nanoseconds
+		double totalLatency = 0.0;
+		uint64_t worstLatency = 0;
+	};
+
+	// Call after every tick
+	void Publish(AgentLink::Link& link, const World::World& world);
+
+	// Inputs of every action due for the tick world is about to take
+	World::Input TakeInput(AgentLink::Link& link, const World::World& world, Stats& stats);
+
+	struct HostConfig
+	{
+		std::string name = "flappy";
+
+		int rounds = 1;
+		int playerCount = 1;
+		float deltaT = World::defaultDeltaT;
+		float maxTime = 60.0f;
+		uint64_t seed = 1;
+
+		// Waits up to timeoutMs for the agent's action on every tick instead of keeping to the clock, so an agent
+		// slower than real time still gets every tick
+		bool isLockstep = false;
+		float timeoutMs = 1000.0f;
+	};
+
+	// Plays rounds without a window, publishing every tick and taking the agent's inputs, then prints the round trip
+	int RunHost(const HostConfig& config);
+
+	struct BotConfig
+	{
+		std::string name = "flappy";
+
+		// Gives up when no game shows up, or no state comes, for this long
+		float idleSeconds = 5.0f;
+	};
+
+	// An example agent in its own process: follows the newest state and flaps player 1 to hover at the bottom of the gap
+	int RunBot(const BotConfig& config);
+
+	// Both sides of a link in one process: an answer to the end of a round must not hold back the next round's, and a
+	// lockstep game must get every tick of two rounds in a row answered. 0 when both hold
+	int RunCheck(const std::string& name);
+}
@@ -0,0 +1,430 @@
+#include "agent_link.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AgentLink
+{
+	// Both processes map the same bytes, so the counters have to work without a lock behind them
+	static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared counters must be lock free");
+
+	template <typename T>
+	struct Entry
+	{
+		// Position in the ring's sequence of writes, to tell a slot that was written over from the one wanted
+		uint64_t index;
+		T value;
+	};
+
+	// Odd sequence while the writer is in the slot; a reader that sees the same even sequence before and after its copy
+	// got the whole entry
+	template <typename T>
+	struct Slot
+	{
+		std::atomic<uint64_t> sequence;
+		Entry<T> entry;
+	};
+
+	struct Shared
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t size;
+
+		// Process id of the game, so a mapping a crashed game left behind can be told from one still in use
+		uint32_t hostProcess;
+		uint32_t reserved;
+
+		// Writes so far to each ring, each on its own cache line since the two sides write them
+		std::atomic<uint64_t> stateCount;
+		char statePadding[56];
+		std::atomic<uint64_t> actionCount;
+		char actionPadding[56];
+
+		Slot<State> states[stateCapacity];
+		Slot<Action> actions[actionCapacity];
+	};
+
+	namespace Variables
+	{
+		const char magic[8] = { 'F', 'L', 'A', 'P', 'A', 'G', 'N', 'T' };
+		const uint32_t version = 3;
+
+		// Readers give up on a slot after this many torn copies; only a writer lapping the ring makes it happen
+		const int maxRetries = 64;
+	}
+
+	static std::string GetMappingName(const std::string& name);
+	static uint32_t GetOwnProcessId();
+#if !defined(_WIN32)
+	static bool IsLeftBehind(const std::string& mappingName);
+#endif
+	static bool Map(Link& link, const std::string& name, bool isHost);
+	static void Unmap(Link& link);
+	static Shared& GetShared(Link& link);
+
+	template <typename T>
+	static void Write(Slot<T>& slot, uint64_t index, const T& value);
+	template <typename T>
+	static bool Read(const Slot<T>& slot, Entry<T>& entry);
+
+	std::string GetMappingName(const std::string& name)
+	{
+#if defined(_WIN32)
+		return "Local\\flappy-agent-" + name;
+#else
+		return "/flappy-agent-" + name;
+#endif
+	}
+
+	uint32_t GetOwnProcessId()
+	{
+#if defined(_WIN32)
+		return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+		return static_cast<uint32_t>(getpid());
+#endif
+	}
+
+#if !defined(_WIN32)
+	bool IsLeftBehind(const std::string& mappingName)
+	{
+		int descriptor = shm_open(mappingName.c_str(), O_RDONLY, 0);
+
+		if (descriptor < 0)
+		{
+			return false;
+		}
+
+		struct stat status;
+		bool isLeftBehind = false;
+
+		// Only a whole mapping of this version says which game made it; anything else may be one still being set up
+		if (fstat(descriptor, &status) == 0 && status.st_size == static_cast<off_t>(sizeof(Shared)))
+		{
+			void* view = mmap(nullptr, sizeof(Shared), PROT_READ, MAP_SHARED, descriptor, 0);
+
+			if (view != MAP_FAILED)
+			{
+				const Shared& shared = *static_cast<const Shared*>(view);
+
+				if (std::memcmp(shared.magic, Variables::magic, sizeof(shared.magic)) == 0 && shared.version == Variables::version)
+				{
+					// EPERM means the process is there, just not ours to signal
+					isLeftBehind = kill(static_cast<pid_t>(shared.hostProcess), 0) != 0 && errno == ESRCH;
+				}
+
+				munmap(view, sizeof(Shared));
+			}
+		}
+
+		close(descriptor);
+
+		return isLeftBehind;
+	}
+#endif
+
+	bool Map(Link& link, const std::string& name, bool isHost)
+	{
+		const std::string mappingName = GetMappingName(name);
+		const size_t size = sizeof(Shared);
+
+#if defined(_WIN32)
+		HANDLE mapping = isHost ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), mappingName.c_str())
+			: OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mappingName.c_str());
+
+		if (mapping == nullptr)
+		{
+			return false;
+		}
+
+		// Another game already hosts this name
+		if (isHost && GetLastError() == ERROR_ALREADY_EXISTS)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+
+		if (view == nullptr)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+
+		link.handle = reinterpret_cast<intptr_t>(mapping);
+		link.shared = view;
+#else
+		int descriptor = isHost ? shm_open(mappingName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600) : shm_open(mappingName.c_str(), O_RDWR, 0);
+
+		// Left behind by a game that didn't get to close it. One whose game still runs fails, as on Windows
+		if (descriptor < 0 && isHost && errno == EEXIST && IsLeftBehind(mappingName))
+		{
+			shm_unlink(mappingName.c_str());
+			descriptor = shm_open(mappingName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+		}
+
+		if (descriptor < 0)
+		{
+			return false;
+		}
+
+		if (isHost && ftruncate(descriptor, static_cast<off_t>(size)) != 0)
+		{
+			close(descriptor);
+			shm_unlink(mappingName.c_str());
+			return false;
+		}
+
+		void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+
+		if (view == MAP_FAILED)
+		{
+			close(descriptor);
+
+			if (isHost)
+			{
+				shm_unlink(mappingName.c_str());
+			}
+
+			return false;
+		}
+
+		link.handle = descriptor;
+		link.shared = view;
+#endif
+
+		link.isHost = isHost;
+		link.name = name;
+		link.stateCursor = 0;
+		link.actionCursor = 0;
+		link.epoch = 0;
+
+		return true;
+	}
+
+	void Unmap(Link& link)
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(link.shared);
+		CloseHandle(reinterpret_cast<HANDLE>(link.handle));
+#else
+		munmap(link.shared, sizeof(Shared));
+		close(static_cast<int>(link.handle));
+
+		if (link.isHost)
+		{
+			shm_unlink(GetMappingName(link.name).c_str());
+		}
+#endif
+
+		link.shared = nullptr;
+	}
+
+	Shared& GetShared(Link& link)
+	{
+		return *static_cast<Shared*>(link.shared);
+	}
+
+	template <typename T>
+	void Write(Slot<T>& slot, uint64_t index, const T& value)
+	{
+		// One writer per ring, so the sequence only needs ordering, not a read-modify-write
+		uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+
+		slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		Entry<T> entry;
+		entry.index = index;
+		entry.value = value;
+		std::memcpy(&slot.entry, &entry, sizeof(entry));
+
+		slot.sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	template <typename T>
+	bool Read(const Slot<T>& slot, Entry<T>& entry)
+	{
+		uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+		if (sequence & 1)
+		{
+			return false;
+		}
+
+		std::memcpy(&entry, &slot.entry, sizeof(entry));
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		return slot.sequence.load(std::memory_order_relaxed) == sequence;
+	}
+
+	bool Create(Link& link, const std::string& name)
+	{
+		if (!Map(link, name, true))
+		{
+			return false;
+		}
+
+		// A new mapping is all zeroes; the magic goes in last so an agent never takes a half made one
+		Shared& shared = GetShared(link);
+		shared.version = Variables::version;
+		shared.size = static_cast<uint32_t>(sizeof(Shared));
+		shared.hostProcess = GetOwnProcessId();
+
+		std::atomic_thread_fence(std::memory_order_release);
+		std::memcpy(shared.magic, Variables::magic, sizeof(shared.magic));
+
+		return true;
+	}
+
+	bool Open(Link& link, const std::string& name)
+	{
+		if (!Map(link, name, false))
+		{
+			return false;
+		}
+
+		Shared& shared = GetShared(link);
+
+		if (std::memcmp(shared.magic, Variables::magic, sizeof(shared.magic)) != 0 || shared.version != Variables::version || shared.size != sizeof(Shared))
+		{
+			Unmap(link);
+			return false;
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// Carries on after an agent that was there before
+		link.actionCursor = shared.actionCount.load(std::memory_order_acquire);
+
+		return true;
+	}
+
+	void Close(Link& link)
+	{
+		if (IsOpen(link))
+		{
+			Unmap(link);
+		}
+	}
+
+	bool IsOpen(const Link& link)
+	{
+		return link.shared != nullptr;
+	}
+
+	void Publish(Link& link, const State& state)
+	{
+		Shared& shared = GetShared(link);
+		uint64_t index = link.stateCursor++;
+
+		State stamped = state;
+		stamped.epoch = link.epoch;
+
+		Write(shared.states[index % stateCapacity], index, stamped);
+		shared.stateCount.store(index + 1, std::memory_order_release);
+	}
+
+	void DropActions(Link& link)
+	{
+		link.epoch++;
+		link.actionCursor = GetShared(link).actionCount.load(std::memory_order_acquire);
+	}
+
+	bool TakeAction(Link& link, uint64_t tick, Action& action)
+	{
+		Shared& shared = GetShared(link);
+		uint64_t count = shared.actionCount.load(std::memory_order_acquire);
+
+		// The agent wrote more than the ring holds since the last call; the oldest are gone
+		if (count - link.actionCursor > static_cast<uint64_t>(actionCapacity))
+		{
+			link.actionCursor = count - actionCapacity;
+		}
+
+		for (int retry = 0; retry < Variables::maxRetries && link.actionCursor < count; retry++)
+		{
+			Entry<Action> entry;
+
+			if (!Read(shared.actions[link.actionCursor % actionCapacity], entry))
+			{
+				continue;
+			}
+
+			// Written over by a later lap, or answering a world that has since restarted or rewound; the ticks of those
+			// mean nothing now
+			if (entry.index != link.actionCursor || entry.value.epoch != link.epoch)
+			{
+				link.actionCursor++;
+				continue;
+			}
+
+			if (entry.value.tick > tick)
+			{
+				return false;
+			}
+
+			link.actionCursor++;
+			action = entry.value;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool ReadNewest(Link& link, State& state)
+	{
+		Shared& shared = GetShared(link);
+
+		for (int retry = 0; retry < Variables::maxRetries; retry++)
+		{
+			uint64_t count = shared.stateCount.load(std::memory_order_acquire);
+
+			if (count == link.stateCursor)
+			{
+				return false;
+			}
+
+			Entry<State> entry;
+
+			if (Read(shared.states[(count - 1) % stateCapacity], entry) && entry.index == count - 1)
+			{
+				link.stateCursor = count;
+				state = entry.value;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void Send(Link& link, const Action& action)
+	{
+		Shared& shared = GetShared(link);
+		uint64_t index = link.actionCursor++;
+
+		Write(shared.actions[index % actionCapacity], index, action);
+		shared.actionCount.store(index + 1, std::memory_order_release);
+	}
+
+	uint64_t GetTime()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+}
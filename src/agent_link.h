@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Shared memory between the game and an outside process driving it. The game publishes every tick's state into one ring
+// and takes inputs from another the agent writes; each slot is a seqlock, so neither side ever waits on the other and
+// nothing is serialized. Kept apart from raylib.h because the platform headers clash with it
+namespace AgentLink
+{
+	const int maxBirds = 8;
+
+	// Ticks of history an agent can fall behind by before it misses states
+	const int stateCapacity = 1024;
+	const int actionCapacity = 1024;
+
+	struct Bird
+	{
+		float y;
+		float velocity;
+		uint8_t isOn;
+	};
+
+	// A tick as the agent sees it; plain numbers so any language can read the mapping
+	struct State
+	{
+		uint64_t tick;
+		uint64_t seed;
+		// Goes up every time the game restarts or rewinds the world, so ticks can repeat; stamped by Publish
+		uint64_t epoch;
+		// GetTime when it was published
+		uint64_t publishTime;
+		float deltaT;
+
+		int32_t score;
+		uint8_t playerCount;
+		uint8_t hasLost;
+
+		float birdX;
+		Bird birds[maxBirds];
+
+		// obstacleX is the obstacle's left edge; gapTop and gapBottom are screen heights, so gapTop < gapBottom
+		float obstacleX;
+		float obstacleWidth;
+		float obstacleVelocity;
+		float gapTop;
+		float gapBottom;
+	};
+
+	struct Action
+	{
+		// Taken on the step from this tick, or the next one if that step already went by
+		uint64_t tick;
+		// epoch of the state the action answers; the game drops actions from before its last restart or rewind
+		uint64_t epoch;
+		// publishTime of the state the action answers, so the game can measure the round trip
+		uint64_t stateTime;
+
+		// Bit i flaps player i
+		uint8_t input;
+	};
+
+	struct Link
+	{
+		intptr_t handle = 0;
+		void* shared = nullptr;
+		bool isHost = false;
+
+		// States the agent has seen, actions the game has taken
+		uint64_t stateCursor = 0;
+		uint64_t actionCursor = 0;
+
+		// Game side, see State::epoch
+		uint64_t epoch = 0;
+
+		std::string name;
+	};
+
+	// The game makes the mapping, the agent opens it; both fail if the other side's is missing or another version.
+	// Making one fails while another running game hosts the name; one a crashed game left behind is taken over
+	bool Create(Link& link, const std::string& name);
+	bool Open(Link& link, const std::string& name);
+	void Close(Link& link);
+
+	bool IsOpen(const Link& link);
+
+	// Game side
+	void Publish(Link& link, const State& state);
+	// For when the world restarts or rewinds: drops every action sent so far, and every one still to come that answers
+	// a state from before. Publish the new state after it
+	void DropActions(Link& link);
+	// Takes the next action due by tick; false when there is none. Actions the agent wrote faster than the game took them
+	// are lost once the ring wraps past them
+	bool TakeAction(Link& link, uint64_t tick, Action& action);
+
+	// Agent side. Copies the newest state when there is one the agent hasn't read
+	bool ReadNewest(Link& link, State& state);
+	void Send(Link& link, const Action& action);
+
+	// Nanoseconds on a clock both processes share
+	uint64_t GetTime();
+}
@@ -0,0 +1,137 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "job_system.h"
+#include "policy.h"
+#include "world.h"
+
+namespace Batch
+{
+	struct Totals
+	{
+		long long steps = 0;
+		long long score = 0;
+		int bestScore = 0;
+
+		// Per worker accumulators, kept apart to avoid false sharing
+		char padding[64];
+	};
+
+	struct Result
+	{
+		Totals totals;
+		double seconds;
+	};
+
+	static Result RunOnce(const Config& config, const Policy::Network* policy);
+	static void Print(const Config& config, int threadCount, const Result& result);
+
+	Result RunOnce(const Config& config, const Policy::Network* policy)
+	{
+		std::vector<Totals> totals(Jobs::GetThreadCount());
+
+		auto start = std::chrono::steady_clock::now();
+
+		Jobs::ParallelFor(config.episodes, config.chunkSize, [&](int begin, int end, int worker)
+		{
+			Totals& local = totals[worker];
+
+			for (int i = begin; i < end; i++)
+			{
+				World::World world;
+				World::Reset(world, 1, config.seed + static_cast<uint64_t>(i));
+				world.deltaT = config.deltaT;
+
+				Rng::Rng policyRng;
+				Rng::Seed(policyRng, config.seed, static_cast<uint64_t>(i) + 1);
+
+				while (!world.hasLost && world.timeAlive < config.maxTime)
+				{
+					bool isMoving = policy ? Policy::Evaluate(*policy, World::Observe(world.birds[0], world.obstacle)) : Rng::Float(policyRng) < config.flapChance;
+
+					World::Step<1>(world, isMoving ? 1 : 0);
+					local.steps++;
+				}
+
+				local.score += world.score;
+				local.bestScore = std::max(local.bestScore, world.score);
+			}
+		});
+
+		Result result;
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		for (const Totals& local : totals)
+		{
+			result.totals.steps += local.steps;
+			result.totals.score += local.score;
+			result.totals.bestScore = std::max(result.totals.bestScore, local.bestScore);
+		}
+
+		return result;
+	}
+
+	void Print(const Config& config, int threadCount, const Result& result)
+	{
+		std::cout << threadCount << " threads: "
+			<< config.episodes << " episodes in " << result.seconds << " s  "
+			<< config.episodes / result.seconds << " episodes/s  "
+			<< result.totals.steps / result.seconds << " steps/s  "
+			<< "mean score " << static_cast<double>(result.totals.score) / config.episodes
+			<< "  best " << result.totals.bestScore;
+	}
+
+	int Run(const Config& config)
+	{
+		Policy::Network policy;
+		bool hasPolicy = !config.policyPath.empty();
+
+		if (hasPolicy && !Policy::Load(policy, config.policyPath))
+		{
+			std::cerr << "could not load policy " << config.policyPath << "\n";
+			return 1;
+		}
+
+		int maxThreads = config.threadCount > 0 ? config.threadCount : static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+
+		if (!config.isScaling)
+		{
+			Jobs::Initialize(maxThreads, config.pinThreads);
+			Print(config, maxThreads, RunOnce(config, hasPolicy ? &policy : nullptr));
+			std::cout << "\n";
+			Jobs::Shutdown();
+			return 0;
+		}
+
+		double baseline = 0.0;
+
+		for (int threadCount = 1; ; threadCount = std::min(threadCount * 2, maxThreads))
+		{
+			Jobs::Initialize(threadCount, config.pinThreads);
+			Result result = RunOnce(config, hasPolicy ? &policy : nullptr);
+			Jobs::Shutdown();
+
+			if (threadCount == 1)
+			{
+				baseline = result.seconds;
+			}
+
+			double speedup = baseline / result.seconds;
+
+			Print(config, threadCount, result);
+			std::cout << "  speedup " << speedup << "x  efficiency " << 100.0 * speedup / threadCount << "%\n";
+
+			if (threadCount == maxThreads)
+			{
+				break;
+			}
+		}
+
+		return 0;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "world.h"
+
+namespace Batch
+{
+	struct Config
+	{
+		int episodes = 100000;
+		int chunkSize = 64;
+		int threadCount = 0;
+		bool pinThreads = false;
+
+		// Reruns the batch at 1, 2, 4... threads and prints speedup over one thread
+		bool isScaling = false;
+
+		float deltaT = World::defaultDeltaT;
+		float maxTime = 60.0f;
+
+		// Used when no policy is given: flap with this chance every tick
+		float flapChance = 0.06f;
+		std::string policyPath;
+
+		uint64_t seed = 1;
+	};
+
+	int Run(const Config& config);
+}
@@ -0,0 +1,188 @@
+#include "bindings.h"
+
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "player.h"
+
+namespace Bindings
+{
+	struct NamedKey
+	{
+		const char* name;
+		KeyboardKey key;
+		const char* keyName;
+	};
+
+	namespace Variables
+	{
+		const char* fileHeader = "flappy-bindings";
+		const int fileVersion = 1;
+
+		// Besides these, single letters and digits name their own key
+		const NamedKey namedKeys[] =
+		{
+			{ "space", KEY_SPACE, "Space" },
+			{ "up", KEY_UP, "Up arrow" },
+			{ "down", KEY_DOWN, "Down arrow" },
+			{ "tab", KEY_TAB, "Tab" },
+			{ "backspace", KEY_BACKSPACE, "Backspace" },
+			{ "left-shift", KEY_LEFT_SHIFT, "Left Shift" },
+			{ "right-shift", KEY_RIGHT_SHIFT, "Right Shift" },
+			{ "left-control", KEY_LEFT_CONTROL, "Left Ctrl" },
+			{ "right-control", KEY_RIGHT_CONTROL, "Right Ctrl" },
+			{ "left-alt", KEY_LEFT_ALT, "Left Alt" },
+			{ "right-alt", KEY_RIGHT_ALT, "Right Alt" },
+			{ "numpad-0", KEY_KP_0, "Numpad 0" },
+			{ "numpad-1", KEY_KP_1, "Numpad 1" },
+			{ "numpad-2", KEY_KP_2, "Numpad 2" },
+			{ "numpad-3", KEY_KP_3, "Numpad 3" },
+			{ "numpad-4", KEY_KP_4, "Numpad 4" },
+			{ "numpad-5", KEY_KP_5, "Numpad 5" },
+			{ "numpad-6", KEY_KP_6, "Numpad 6" },
+			{ "numpad-7", KEY_KP_7, "Numpad 7" },
+			{ "numpad-8", KEY_KP_8, "Numpad 8" },
+			{ "numpad-9", KEY_KP_9, "Numpad 9" }
+		};
+
+		// Pause and rewind
+		const char reservedLetters[] = "PR";
+	}
+
+	static bool FindKey(const std::string& name, Binding& binding);
+
+	Binding players[World::maxPlayers] =
+	{
+		{ KEY_W, "W" },
+		{ KEY_UP, "Up arrow" },
+		{ KEY_V, "V" },
+		{ KEY_M, "M" },
+		{ KEY_T, "T" },
+		{ KEY_I, "I" },
+		{ KEY_KP_5, "Numpad 5" },
+		{ KEY_SPACE, "Space" }
+	};
+
+	bool FindKey(const std::string& name, Binding& binding)
+	{
+		if (name.size() == 1 && std::isalnum(static_cast<unsigned char>(name[0])))
+		{
+			// raylib numbers letters and digits by their uppercase character
+			char character = static_cast<char>(std::toupper(static_cast<unsigned char>(name[0])));
+
+			for (const char* reserved = Variables::reservedLetters; *reserved != '\0'; reserved++)
+			{
+				if (character == *reserved)
+				{
+					return false;
+				}
+			}
+
+			binding.flapKey = static_cast<KeyboardKey>(character);
+			binding.keyName = std::string(1, character);
+			return true;
+		}
+
+		for (const NamedKey& namedKey : Variables::namedKeys)
+		{
+			if (name == namedKey.name)
+			{
+				binding.flapKey = namedKey.key;
+				binding.keyName = namedKey.keyName;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool Load(const std::string& path)
+	{
+		std::ifstream file(path);
+
+		std::string header;
+		int version = 0;
+
+		if (!(file >> header >> version) || header != Variables::fileHeader || version != Variables::fileVersion)
+		{
+			return false;
+		}
+
+		Binding loaded[World::maxPlayers];
+		std::string line;
+		int lineNumber = 1;
+
+		for (int i = 0; i < World::maxPlayers; i++)
+		{
+			loaded[i] = players[i];
+		}
+
+		while (std::getline(file, line))
+		{
+			std::istringstream words(line.substr(0, line.find('#')));
+			std::string name;
+			std::string keyName;
+			std::string extra;
+
+			if (!(words >> name))
+			{
+				lineNumber++;
+				continue;
+			}
+
+			// player-1 to player-8
+			int player = name.size() == 8 && name.compare(0, 7, "player-") == 0 ? name[7] - '1' : -1;
+
+			if (player < 0 || player >= World::maxPlayers)
+			{
+				std::cerr << path << ":" << lineNumber << ": unknown setting " << name << "\n";
+				return false;
+			}
+
+			if (!(words >> keyName) || (words >> extra) || !FindKey(keyName, loaded[player]))
+			{
+				std::cerr << path << ":" << lineNumber << ": bad key for " << name << ", expected a letter other than P or R, a digit or one of the names in the file's comments\n";
+				return false;
+			}
+
+			lineNumber++;
+		}
+
+		// Two players on one key would always flap together
+		for (int i = 0; i < World::maxPlayers; i++)
+		{
+			for (int j = 0; j < i; j++)
+			{
+				if (loaded[i].flapKey == loaded[j].flapKey)
+				{
+					std::cerr << path << ": players " << j + 1 << " and " << i + 1 << " both flap with " << loaded[i].keyName << "\n";
+					return false;
+				}
+			}
+		}
+
+		for (int i = 0; i < World::maxPlayers; i++)
+		{
+			players[i] = loaded[i];
+		}
+
+		return true;
+	}
+
+	World::Input Read(int playerCount)
+	{
+		World::Input input = 0;
+
+		for (int i = 0; i < playerCount && i < World::maxPlayers; i++)
+		{
+			if (Player::IsPlayerMoving(players[i].flapKey))
+			{
+				input |= static_cast<World::Input>(1 << i);
+			}
+		}
+
+		return input;
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+
+#include "raylib.h"
+
+#include "world.h"
+
+namespace Bindings
+{
+	struct Binding
+	{
+		KeyboardKey flapKey;
+		std::string keyName;
+	};
+
+	// Player i flaps with players[i]; keys used by menus (P, R, Enter, arrows left/right, F keys) are left out
+	extern Binding players[World::maxPlayers];
+
+	// Reads a flap key per player from the file; players it leaves out keep theirs. Prints the first bad line and changes
+	// nothing on errors
+	bool Load(const std::string& path);
+
+	// Flaps pressed this frame by the first playerCount players, bit i for player i
+	World::Input Read(int playerCount);
+}
@@ -0,0 +1,109 @@
+#include "canvas.h"
+
+namespace Canvas
+{
+	namespace Variables
+	{
+		static thread_local SoftRender::Frame* target = nullptr;
+	}
+
+	bool LoadSprite(Sprite& sprite, const std::string& path)
+	{
+		sprite = Sprite();
+
+		Image image = LoadImage(path.c_str());
+
+		if (image.data == nullptr)
+		{
+			return false;
+		}
+
+		ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		sprite.image = SoftRender::FromRgba(image.width, image.height, static_cast<const uint8_t*>(image.data));
+
+		// Headless tools have no GL context to upload to
+		if (IsWindowReady())
+		{
+			sprite.texture = LoadTextureFromImage(image);
+			sprite.hasTexture = true;
+		}
+
+		UnloadImage(image);
+
+		return true;
+	}
+
+	void UnloadSprite(Sprite& sprite)
+	{
+		if (sprite.hasTexture)
+		{
+			UnloadTexture(sprite.texture);
+		}
+
+		sprite = Sprite();
+	}
+
+	void SetTarget(SoftRender::Frame* frame)
+	{
+		Variables::target = frame;
+	}
+
+	SoftRender::Frame* GetTarget()
+	{
+		return Variables::target;
+	}
+
+	void DrawRectangle(int x, int y, int width, int height, Color color)
+	{
+		if (Variables::target)
+		{
+			SoftRender::FillRectangle(*Variables::target, x, y, width, height, color);
+		}
+		else
+		{
+			::DrawRectangle(x, y, width, height, color);
+		}
+	}
+
+	void DrawCircle(Vector2 center, float radius, Color color)
+	{
+		if (Variables::target)
+		{
+			SoftRender::FillCircle(*Variables::target, center, radius, color);
+		}
+		else
+		{
+			DrawCircleV(center, radius, color);
+		}
+	}
+
+	void DrawSprite(const Sprite& sprite, float x, float y, float width, float height, Color tint)
+	{
+		if (Variables::target)
+		{
+			SoftRender::DrawImage(*Variables::target, sprite.image, x, y, width, height, tint);
+		}
+		else if (sprite.hasTexture)
+		{
+			Rectangle source = { 0.0f, 0.0f, static_cast<float>(sprite.texture.width), static_cast<float>(sprite.texture.height) };
+			DrawTexturePro(sprite.texture, source, { x, y, width, height }, { 0.0f, 0.0f }, 0.0f, tint);
+		}
+	}
+
+	void DrawText(const char* text, int x, int y, int fontSize, Color color)
+	{
+		if (Variables::target)
+		{
+			SoftRender::DrawString(*Variables::target, text, x, y, fontSize, color);
+		}
+		else
+		{
+			::DrawText(text, x, y, fontSize, color);
+		}
+	}
+
+	int MeasureText(const char* text, int fontSize)
+	{
+		return Variables::target ? SoftRender::MeasureString(text, fontSize) : ::MeasureText(text, fontSize);
+	}
+}
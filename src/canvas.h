@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+
+#include "raylib.h"
+
+#include "soft_render.h"
+
+// Draw calls for gameplay visuals that either go straight to raylib or, when a software frame is the target, get recorded into it
+namespace Canvas
+{
+	// Keeps the pixels on the CPU as well, so the sprite can be drawn without a GPU
+	struct Sprite
+	{
+		Texture texture;
+		bool hasTexture;
+
+		SoftRender::Image image;
+	};
+
+	bool LoadSprite(Sprite& sprite, const std::string& path);
+	void UnloadSprite(Sprite& sprite);
+
+	// Per thread; nullptr draws with raylib
+	void SetTarget(SoftRender::Frame* frame);
+	SoftRender::Frame* GetTarget();
+
+	void DrawRectangle(int x, int y, int width, int height, Color color);
+	void DrawCircle(Vector2 center, float radius, Color color);
+	void DrawSprite(const Sprite& sprite, float x, float y, float width, float height, Color tint);
+	void DrawText(const char* text, int x, int y, int fontSize, Color color);
+	int MeasureText(const char* text, int fontSize);
+}
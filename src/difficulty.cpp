@@ -0,0 +1,61 @@
+#include "difficulty.h"
+
+namespace Difficulty
+{
+	static float Evaluate(const Tuning::Curve& curve, float plain, uint8_t& segment, int score, float timeAlive);
+
+	float Evaluate(const Tuning::Curve& curve, float plain, uint8_t& segment, int score, float timeAlive)
+	{
+		if (curve.pointCount == 0)
+		{
+			segment = 0;
+			return plain;
+		}
+
+		const Tuning::CurvePoint* points = curve.points;
+		const int last = curve.pointCount - 1;
+
+		float at = curve.axis == Tuning::CurveAxis::Score ? static_cast<float>(score) : timeAlive;
+
+		// Walks from the last segment, which is the one at or next to this tick's in almost every call; going back covers
+		// rewinds and tuning reloads
+		int index = segment < last ? segment : last;
+
+		while (index < last && at >= points[index + 1].at)
+		{
+			index++;
+		}
+
+		while (index > 0 && at < points[index].at)
+		{
+			index--;
+		}
+
+		segment = static_cast<uint8_t>(index);
+
+		if (at <= points[index].at || index == last)
+		{
+			return points[index].value;
+		}
+
+		const Tuning::CurvePoint& from = points[index];
+		const Tuning::CurvePoint& to = points[index + 1];
+
+		return from.value + (to.value - from.value) * (at - from.at) / (to.at - from.at);
+	}
+
+	void Reset(State& state)
+	{
+		state = State();
+		Advance(state, 0, 0.0f);
+	}
+
+	void Advance(State& state, int score, float timeAlive)
+	{
+		const Tuning::Tuning& tuning = Tuning::Get();
+
+		state.levels.obstacleVelocity = Evaluate(tuning.obstacleVelocityCurve, tuning.obstacleVelocity, state.segments[0], score, timeAlive);
+		state.levels.gapSpace = Evaluate(tuning.gapSpaceCurve, tuning.gapSpace, state.segments[1], score, timeAlive);
+		state.levels.obstacleSpacing = Evaluate(tuning.obstacleSpacingCurve, tuning.obstacleSpacing, state.segments[2], score, timeAlive);
+	}
+}
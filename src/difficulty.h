@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+
+#include "tuning.h"
+
+// Obstacle speed, gap and spacing as the round goes on, following the curves in the tuning
+namespace Difficulty
+{
+	// What obstacles are set with right now
+	struct Levels
+	{
+		float obstacleVelocity;
+		float gapSpace;
+		float obstacleSpacing;
+	};
+
+	// Plain data kept in the world, so snapshots and rewinds carry it and replays play it back the same
+	struct State
+	{
+		Levels levels;
+
+		// Segment of each curve the last Advance ended on. Score and time only move a little per tick, so finding the next
+		// segment is a step or two from here instead of a search
+		uint8_t segments[3];
+	};
+
+	// Levels at score 0 and no time alive
+	void Reset(State& state);
+
+	// Once per tick, after the score changed; constant time unless the tuning was swapped for curves far apart
+	void Advance(State& state, int score, float timeAlive);
+}
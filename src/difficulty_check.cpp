@@ -0,0 +1,234 @@
+#include "difficulty_check.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "globals.h"
+#include "job_system.h"
+#include "tuning.h"
+
+namespace DifficultyCheck
+{
+	// Heights the bird's center can be at while inside a gap
+	struct Band
+	{
+		float top;
+		float bottom;
+	};
+
+	struct Failure
+	{
+		uint64_t seed;
+		int gap;
+		int score;
+		float timeAlive;
+		Difficulty::Levels levels;
+		const char* reason;
+	};
+
+	struct SeedResult
+	{
+		int gapCount = 0;
+		bool hasFailed = false;
+		Failure failure;
+
+		// Hardest levels seen
+		float fastest = 0.0f;
+		float narrowest = 0.0f;
+	};
+
+	static Band GetBand(const Obstacle::Obstacle& obstacle, float radius);
+	static float GetDistance(Band from, Band to);
+	static float GetLeastExtent(int ticks, float deltaT);
+	static SeedResult CheckSeed(const Config& config, uint64_t seed);
+
+	Band GetBand(const Obstacle::Obstacle& obstacle, float radius)
+	{
+		// bottom is the upper pipe
+		return { obstacle.bottom.y + obstacle.height + radius, obstacle.top.y - radius };
+	}
+
+	float GetDistance(Band from, Band to)
+	{
+		// Positive when to is below from
+		if (to.top > from.bottom)
+		{
+			return to.top - from.bottom;
+		}
+
+		if (to.bottom < from.top)
+		{
+			return to.bottom - from.top;
+		}
+
+		return 0.0f;
+	}
+
+	float GetLeastExtent(int ticks, float deltaT)
+	{
+		// Between flaps the bird follows a parabola. The least height any stretch of its path covers is that of the same
+		// stretch centered on an apex, and past the time from flap to fall back to the same height, one whole arc
+		const Tuning::Tuning& tuning = Tuning::Get();
+
+		if (tuning.gravity <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		float time = std::min(ticks * deltaT, 2.0f * tuning.flapVelocity / tuning.gravity);
+
+		return tuning.gravity * time * time / 8.0f;
+	}
+
+	SeedResult CheckSeed(const Config& config, uint64_t seed)
+	{
+		const Tuning::Tuning& tuning = Tuning::Get();
+		const float radius = tuning.birdRadius;
+
+		SeedResult result;
+
+		World::World world;
+		World::Reset(world, 1, seed);
+		world.deltaT = config.deltaT;
+
+		Player::Bird& bird = world.birds[0];
+		const float birdX = bird.position.x;
+
+		// The bird starts as a point in the middle of the screen
+		Band previous = { bird.position.y, bird.position.y };
+		uint64_t exitTick = 0;
+		uint64_t enterTick = 0;
+		bool isInside = false;
+
+		result.narrowest = world.difficulty.levels.gapSpace;
+
+		auto fail = [&](const char* reason)
+		{
+			result.hasFailed = true;
+			result.failure = { seed, result.gapCount, world.score, world.timeAlive, world.difficulty.levels, reason };
+		};
+
+		while (result.gapCount < config.gaps && !result.hasFailed)
+		{
+			const Obstacle::Obstacle& obstacle = world.obstacle;
+			Band band = GetBand(obstacle, radius);
+
+			// Kept in the middle of the gap ahead, so the generator plays on whatever the gaps are
+			bird.position.y = (band.top + band.bottom) * 0.5f;
+			bird.velocity = 0.0f;
+
+			World::Step<1>(world, 0);
+
+			result.fastest = std::max(result.fastest, obstacle.velocity);
+
+			if (world.hasLost)
+			{
+				fail("the gap is narrower than the bird");
+				break;
+			}
+
+			bool isOverlapping = obstacle.bottom.x < birdX + radius && obstacle.bottom.x + obstacle.width > birdX - radius;
+
+			if (isOverlapping && !isInside)
+			{
+				band = GetBand(obstacle, radius);
+				result.narrowest = std::min(result.narrowest, obstacle.top.y - (obstacle.bottom.y + obstacle.height));
+
+				// Flapping every tick rises flapVelocity * deltaT a tick; falling from rest drops gravity * deltaT^2 * n(n+1)/2
+				int ticks = static_cast<int>(world.tick - exitTick);
+				float distance = GetDistance(previous, band);
+				float rise = tuning.flapVelocity * config.deltaT * ticks;
+				float fall = tuning.gravity * config.deltaT * config.deltaT * ticks * (ticks + 1) * 0.5f;
+
+				if (distance < 0.0f && -distance > rise)
+				{
+					fail("too high to climb to from the previous gap");
+				}
+				else if (distance > 0.0f && distance > fall)
+				{
+					fail("too low to fall to from the previous gap");
+				}
+
+				previous = band;
+				enterTick = world.tick;
+				isInside = true;
+			}
+			else if (!isOverlapping && isInside)
+			{
+				if (previous.bottom - previous.top < GetLeastExtent(static_cast<int>(world.tick - enterTick), config.deltaT))
+				{
+					fail("too short for the bird to stay in while the obstacle goes by");
+				}
+
+				exitTick = world.tick;
+				isInside = false;
+				result.gapCount++;
+			}
+		}
+
+		return result;
+	}
+
+	int Run(const Config& config)
+	{
+		if (config.seeds < 1 || config.gaps < 1 || !(config.deltaT > 0.0f))
+		{
+			std::cerr << "seeds, gaps and dt must be positive\n";
+			return 1;
+		}
+
+		Jobs::Initialize(config.threadCount, config.pinThreads);
+
+		std::vector<SeedResult> results(config.seeds);
+
+		Jobs::ParallelFor(config.seeds, 4, [&](int begin, int end, int)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				results[i] = CheckSeed(config, config.seed + static_cast<uint64_t>(i));
+			}
+		});
+
+		Jobs::Shutdown();
+
+		long long gapCount = 0;
+		int failureCount = 0;
+		float fastest = 0.0f;
+		float narrowest = static_cast<float>(Externs::screenHeight);
+
+		for (const SeedResult& result : results)
+		{
+			gapCount += result.gapCount;
+			fastest = std::max(fastest, result.fastest);
+			narrowest = std::min(narrowest, result.narrowest);
+
+			if (!result.hasFailed)
+			{
+				continue;
+			}
+
+			// The first few are enough to find the curve segment at fault
+			if (failureCount < 10)
+			{
+				const Failure& failure = result.failure;
+
+				std::cout << "seed " << failure.seed << " gap " << failure.gap << " (score " << failure.score << ", " << failure.timeAlive << " s): " << failure.reason
+					<< "; speed " << failure.levels.obstacleVelocity << ", gap " << failure.levels.gapSpace << ", spacing " << failure.levels.obstacleSpacing << "\n";
+			}
+
+			failureCount++;
+		}
+
+		std::cout << gapCount << " gaps over " << config.seeds << " seeds, fastest obstacle " << fastest << " px/s, narrowest gap " << narrowest << " px: ";
+
+		if (failureCount > 0)
+		{
+			std::cout << failureCount << " seeds reach a gap the bird can't\n";
+			return 1;
+		}
+
+		std::cout << "every gap is reachable\n";
+		return 0;
+	}
+}
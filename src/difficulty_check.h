@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+#include "world.h"
+
+namespace DifficultyCheck
+{
+	struct Config
+	{
+		int seeds = 200;
+		// Obstacles played through per seed
+		int gaps = 100;
+
+		float deltaT = World::defaultDeltaT;
+		uint64_t seed = 1;
+
+		int threadCount = 0;
+		bool pinThreads = false;
+	};
+
+	// Plays the obstacle generator under the current tuning, difficulty curves included, with a bird kept in the middle of
+	// every gap. Each gap is then checked against what the bird can physically do: fit through it while the obstacle goes
+	// by, and get to it from the previous gap by flapping or falling in the time between the two. Returns 1 if any gap can't
+	// be reached
+	int Run(const Config& config);
+}
@@ -0,0 +1,248 @@
+#include "flappy_env.h"
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "job_system.h"
+#include "tuning.h"
+#include "world.h"
+
+struct FlappyEnv
+{
+	// Stored back to back, so a worker's chunk of environments is one run of memory
+	std::vector<World::World> worlds;
+	std::vector<uint64_t> seeds;
+
+	float deltaT;
+
+	// Set on every worker for the batch's calls, so batches never see each other's
+	Tuning::Tuning tuning;
+};
+
+namespace Env
+{
+	// Environments a worker takes at a time. A step of one is well under a microsecond, so fewer than this many aren't
+	// worth waking the pool for
+	const int chunkSize = 256;
+
+	namespace Variables
+	{
+		// The job system is one per process; it lives while any environment does
+		static std::mutex poolMutex;
+		static int envCount = 0;
+	}
+
+	static void ResetWorlds(FlappyEnv& env);
+	static void StepRange(FlappyEnv& env, int begin, int end, const uint8_t* actions, float* rewards, uint8_t* dones, float* observations);
+	static void Observe(const World::World& world, float* observation);
+	static void ForEachChunk(const FlappyEnv& env, const Jobs::RangeJob& job);
+
+	void ResetWorlds(FlappyEnv& env)
+	{
+		ForEachChunk(env, [&env](int begin, int end, int)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				World::Reset(env.worlds[i], 1, env.seeds[i]);
+				env.worlds[i].deltaT = env.deltaT;
+			}
+		});
+	}
+
+	void Observe(const World::World& world, float* observation)
+	{
+		World::Observation values = World::Observe(world.birds[0], world.obstacle);
+
+		observation[0] = values.birdY;
+		observation[1] = values.birdVelocity;
+		observation[2] = values.gapY;
+		observation[3] = values.gapDistance;
+	}
+
+	void StepRange(FlappyEnv& env, int begin, int end, const uint8_t* actions, float* rewards, uint8_t* dones, float* observations)
+	{
+		const uint64_t count = env.worlds.size();
+
+		for (int i = begin; i < end; i++)
+		{
+			World::World& world = env.worlds[i];
+			int score = world.score;
+
+			World::Step<1>(world, actions[i] != 0 ? 1 : 0);
+
+			float reward = static_cast<float>(world.score - score);
+			bool isDone = world.hasLost;
+
+			if (isDone)
+			{
+				reward = -1.0f;
+				env.seeds[i] += count;
+
+				World::Reset(world, 1, env.seeds[i]);
+				world.deltaT = env.deltaT;
+			}
+
+			if (rewards != nullptr)
+			{
+				rewards[i] = reward;
+			}
+
+			if (dones != nullptr)
+			{
+				dones[i] = isDone ? 1 : 0;
+			}
+
+			if (observations != nullptr)
+			{
+				Observe(world, observations + static_cast<size_t>(i) * FLAPPY_ENV_OBSERVATION_SIZE);
+			}
+		}
+	}
+
+	void ForEachChunk(const FlappyEnv& env, const Jobs::RangeJob& job)
+	{
+		int count = static_cast<int>(env.worlds.size());
+
+		const Jobs::RangeJob tunedJob = [&env, &job](int begin, int end, int worker)
+		{
+			Tuning::SetOverride(&env.tuning);
+			job(begin, end, worker);
+			Tuning::SetOverride(nullptr);
+		};
+
+		if (count <= chunkSize || Jobs::GetThreadCount() == 1)
+		{
+			tunedJob(0, count, 0);
+			return;
+		}
+
+		Jobs::ParallelFor(count, chunkSize, tunedJob);
+	}
+}
+
+FlappyEnv* FlappyEnvCreate(int count, float deltaT, int threadCount)
+{
+	if (count < 1 || !(deltaT >= 0.0f) || threadCount < 0)
+	{
+		return nullptr;
+	}
+
+	FlappyEnv* env = new (std::nothrow) FlappyEnv();
+
+	if (env == nullptr)
+	{
+		return nullptr;
+	}
+
+	try
+	{
+		env->worlds.resize(count);
+		env->seeds.resize(count);
+	}
+	catch (const std::bad_alloc&)
+	{
+		delete env;
+		return nullptr;
+	}
+
+	env->deltaT = deltaT > 0.0f ? deltaT : World::defaultDeltaT;
+
+	{
+		std::lock_guard<std::mutex> lock(Env::Variables::poolMutex);
+
+		// The pool is already running with its own count, which a batch asking for another wouldn't get
+		if (Env::Variables::envCount > 0 && threadCount != 0 && threadCount != Jobs::GetThreadCount())
+		{
+			delete env;
+			return nullptr;
+		}
+
+		if (Env::Variables::envCount++ == 0)
+		{
+			Jobs::Initialize(threadCount, false);
+		}
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		env->seeds[i] = static_cast<uint64_t>(i) + 1;
+	}
+
+	Env::ResetWorlds(*env);
+
+	return env;
+}
+
+void FlappyEnvDestroy(FlappyEnv* env)
+{
+	if (env == nullptr)
+	{
+		return;
+	}
+
+	delete env;
+
+	std::lock_guard<std::mutex> lock(Env::Variables::poolMutex);
+
+	if (--Env::Variables::envCount == 0)
+	{
+		Jobs::Shutdown();
+	}
+}
+
+int FlappyEnvGetCount(const FlappyEnv* env)
+{
+	return env != nullptr ? static_cast<int>(env->worlds.size()) : 0;
+}
+
+void FlappyEnvReset(FlappyEnv* env, const uint64_t* seeds)
+{
+	if (env == nullptr || seeds == nullptr)
+	{
+		return;
+	}
+
+	std::copy(seeds, seeds + env->seeds.size(), env->seeds.begin());
+	Env::ResetWorlds(*env);
+}
+
+void FlappyEnvStep(FlappyEnv* env, const uint8_t* actions, float* rewards, uint8_t* dones, float* observations)
+{
+	if (env == nullptr || actions == nullptr)
+	{
+		return;
+	}
+
+	Env::ForEachChunk(*env, [=](int begin, int end, int)
+	{
+		Env::StepRange(*env, begin, end, actions, rewards, dones, observations);
+	});
+}
+
+void FlappyEnvObserve(const FlappyEnv* env, float* observations)
+{
+	if (env == nullptr || observations == nullptr)
+	{
+		return;
+	}
+
+	Env::ForEachChunk(*env, [=](int begin, int end, int)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			Env::Observe(env->worlds[i], observations + static_cast<size_t>(i) * FLAPPY_ENV_OBSERVATION_SIZE);
+		}
+	});
+}
+
+int FlappyEnvLoadTuning(FlappyEnv* env, const char* path)
+{
+	if (env == nullptr || path == nullptr || !Tuning::Load(env->tuning, path))
+	{
+		return 0;
+	}
+
+	return 1;
+}
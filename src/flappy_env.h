@@ -0,0 +1,52 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// C interface to a batch of single player games, for training agents from other languages. Every environment is its own
+// World stepped with the game's physics and obstacles. Each batch has its own tuning; every batch in the process shares one
+// pool of threads, so steps of different batches take turns. Buffers belong to the caller and are written in place,
+// environment i at index i, observations FLAPPY_ENV_OBSERVATION_SIZE floats apiece
+#if defined(_WIN32) && defined(FLAPPY_ENV_EXPORTS)
+#define FLAPPY_ENV_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define FLAPPY_ENV_API __declspec(dllimport)
+#else
+#define FLAPPY_ENV_API __attribute__((visibility("default")))
+#endif
+
+// Bird height, bird velocity, height of the gap's center and distance to the obstacle, as World::Observe has them
+#define FLAPPY_ENV_OBSERVATION_SIZE 4
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	typedef struct FlappyEnv FlappyEnv;
+
+	// count environments stepped deltaT seconds at a time, or the game's tick when deltaT is 0, on the default tuning.
+	// The first batch made while no other is alive starts threadCount threads, every hardware thread when 0; later ones
+	// share them, so they take 0 or the same count. NULL on bad arguments
+	FLAPPY_ENV_API FlappyEnv* FlappyEnvCreate(int count, float deltaT, int threadCount);
+	FLAPPY_ENV_API void FlappyEnvDestroy(FlappyEnv* env);
+
+	FLAPPY_ENV_API int FlappyEnvGetCount(const FlappyEnv* env);
+
+	// Starts every environment over, environment i on seeds[i]. Seeds of environments that lose later go up by count,
+	// so no two games in a batch share one
+	FLAPPY_ENV_API void FlappyEnvReset(FlappyEnv* env, const uint64_t* seeds);
+
+	// Advances every environment one tick, flapping those with a nonzero action. rewards gets 1 for each obstacle passed
+	// and -1 on losing; dones is set for environments that lost, which start over on their next seed in the same call, so
+	// observations, when not NULL, already show the new game. rewards and dones may be NULL too
+	FLAPPY_ENV_API void FlappyEnvStep(FlappyEnv* env, const uint8_t* actions, float* rewards, uint8_t* dones, float* observations);
+
+	FLAPPY_ENV_API void FlappyEnvObserve(const FlappyEnv* env, float* observations);
+
+	// Swaps in the gameplay constants in the file at path for this batch only; 0 if it can't be read. Not while a call on
+	// the same batch is running, other batches are unaffected
+	FLAPPY_ENV_API int FlappyEnvLoadTuning(FlappyEnv* env, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
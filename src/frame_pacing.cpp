@@ -0,0 +1,312 @@
+#include "frame_pacing.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "raylib.h"
+
+namespace FramePacing
+{
+	namespace Variables
+	{
+		static Mode mode = Mode::VSync;
+		static int targetFps = 60;
+
+		static double period = 1.0 / 60.0;
+		static double deadline = 0.0;
+		static double lastFrameEnd = 0.0;
+		static double totalFrameTime = 0.0;
+
+		static bool isLimiterOn = false;
+		static bool isVSyncOn = false;
+
+		static Stats stats;
+
+		const double missTolerance = 0.0005;
+		const double vsyncMissFactor = 1.5;
+	}
+
+	// Running mean/variance of how long a 1 ms sleep really takes, so the limiter only spins for the part the OS can't be trusted with
+	namespace SleepEstimate
+	{
+		static double mean = 0.002;
+		static double m2 = 0.0;
+		static long long count = 1;
+
+		const long long maxCount = 512;
+
+		static void Update(double observed);
+		static double Get();
+	}
+
+	namespace Adaptive
+	{
+		static double windowStart = 0.0;
+		static int windowFrames = 0;
+		static int windowMisses = 0;
+
+		const double windowLength = 1.0;
+
+		static void Update(double now, bool missed);
+	}
+
+	static int GetRefreshRate();
+	static void ApplyVSync(bool isOn);
+	static void WaitUntil(double target);
+	static void RecordFrame(double frameTime, bool missed);
+
+	namespace SleepEstimate
+	{
+		void Update(double observed)
+		{
+			if (count < maxCount)
+			{
+				count++;
+			}
+
+			double delta = observed - mean;
+			mean += delta / static_cast<double>(count);
+			m2 += delta * (observed - mean);
+
+			if (count == maxCount)
+			{
+				m2 *= static_cast<double>(maxCount - 1) / static_cast<double>(maxCount);
+			}
+		}
+
+		double Get()
+		{
+			return mean + std::sqrt(m2 / static_cast<double>(count));
+		}
+	}
+
+	namespace Adaptive
+	{
+		void Update(double now, bool missed)
+		{
+			windowFrames++;
+
+			if (missed)
+			{
+				windowMisses++;
+			}
+
+			if (now - windowStart < windowLength)
+			{
+				return;
+			}
+
+			Variables::period = 1.0 / GetRefreshRate();
+
+			if (Variables::isVSyncOn && windowMisses * 20 > windowFrames)
+			{
+				// Vsync would halve the frame rate, so tear instead until we keep up again
+				ApplyVSync(false);
+				Variables::isLimiterOn = true;
+				Variables::deadline = now + Variables::period;
+			}
+			else if (!Variables::isVSyncOn && windowMisses == 0)
+			{
+				ApplyVSync(true);
+				Variables::isLimiterOn = false;
+			}
+
+			windowStart = now;
+			windowFrames = 0;
+			windowMisses = 0;
+		}
+	}
+
+	int GetRefreshRate()
+	{
+		int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+
+		return refreshRate > 0 ? refreshRate : 60;
+	}
+
+	void ApplyVSync(bool isOn)
+	{
+		if (isOn)
+		{
+			SetWindowState(FLAG_VSYNC_HINT);
+		}
+		else
+		{
+			ClearWindowState(FLAG_VSYNC_HINT);
+		}
+
+		Variables::isVSyncOn = isOn;
+	}
+
+	void WaitUntil(double target)
+	{
+		double now = GetTime();
+
+		while (target - now > SleepEstimate::Get())
+		{
+			double sleepStart = now;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			now = GetTime();
+
+			SleepEstimate::Update(now - sleepStart);
+		}
+
+		while (now < target)
+		{
+			std::this_thread::yield();
+			now = GetTime();
+		}
+	}
+
+	void RecordFrame(double frameTime, bool missed)
+	{
+		Stats& stats = Variables::stats;
+
+		stats.frames++;
+
+		if (missed)
+		{
+			stats.missedDeadlines++;
+		}
+
+		Variables::totalFrameTime += frameTime;
+
+		stats.lastFrameTime = frameTime;
+		stats.averageFrameTime = Variables::totalFrameTime / static_cast<double>(stats.frames);
+
+		if (frameTime > stats.worstFrameTime)
+		{
+			stats.worstFrameTime = frameTime;
+		}
+
+		stats.targetFrameTime = Variables::period;
+		stats.isVSyncOn = Variables::isVSyncOn;
+	}
+
+	void Initialize(Mode mode, int targetFps)
+	{
+		// raylib's own wait in EndDrawing is a plain sleep and would fight with ours
+		SetTargetFPS(0);
+
+		SetMode(mode, targetFps);
+		ResetStats();
+	}
+
+	void SetMode(Mode mode, int targetFps)
+	{
+		Variables::mode = mode;
+		Variables::targetFps = targetFps;
+
+		switch (mode)
+		{
+		case Mode::VSync:
+			ApplyVSync(true);
+			Variables::isLimiterOn = false;
+			Variables::period = 1.0 / GetRefreshRate();
+			break;
+
+		case Mode::FixedCap:
+			ApplyVSync(false);
+			Variables::isLimiterOn = true;
+			Variables::period = 1.0 / (targetFps > 0 ? targetFps : GetRefreshRate());
+			break;
+
+		case Mode::Uncapped:
+			ApplyVSync(false);
+			Variables::isLimiterOn = false;
+			Variables::period = 0.0;
+			break;
+
+		case Mode::Adaptive:
+			ApplyVSync(true);
+			Variables::isLimiterOn = false;
+			Variables::period = 1.0 / GetRefreshRate();
+			break;
+
+		default:
+			break;
+		}
+
+		double now = GetTime();
+
+		Variables::deadline = now + Variables::period;
+		Variables::lastFrameEnd = now;
+
+		Adaptive::windowStart = now;
+		Adaptive::windowFrames = 0;
+		Adaptive::windowMisses = 0;
+	}
+
+	Mode GetMode()
+	{
+		return Variables::mode;
+	}
+
+	const char* GetModeName(Mode mode)
+	{
+		switch (mode)
+		{
+		case Mode::VSync:
+			return "VSync";
+		case Mode::FixedCap:
+			return "Fixed cap";
+		case Mode::Uncapped:
+			return "Uncapped";
+		case Mode::Adaptive:
+			return "Adaptive";
+		default:
+			return "Unknown";
+		}
+	}
+
+	void EndFrame()
+	{
+		double now = GetTime();
+		bool missed = false;
+
+		if (Variables::isLimiterOn)
+		{
+			missed = now > Variables::deadline + Variables::missTolerance;
+
+			if (now > Variables::deadline + Variables::period)
+			{
+				// Too far behind to catch up, start a new schedule instead of bursting frames
+				Variables::deadline = now;
+			}
+			else
+			{
+				WaitUntil(Variables::deadline);
+			}
+
+			Variables::deadline += Variables::period;
+			now = GetTime();
+		}
+		else if (Variables::isVSyncOn)
+		{
+			missed = now - Variables::lastFrameEnd > Variables::period * Variables::vsyncMissFactor;
+		}
+
+		if (Variables::mode == Mode::Adaptive)
+		{
+			Adaptive::Update(now, missed);
+		}
+
+		RecordFrame(now - Variables::lastFrameEnd, missed);
+		Variables::lastFrameEnd = now;
+	}
+
+	Stats GetStats()
+	{
+		return Variables::stats;
+	}
+
+	void ResetStats()
+	{
+		Variables::stats = Stats();
+		Variables::stats.targetFrameTime = Variables::period;
+		Variables::stats.isVSyncOn = Variables::isVSyncOn;
+		Variables::totalFrameTime = 0.0;
+		Variables::lastFrameEnd = GetTime();
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+namespace FramePacing
+{
+	enum class Mode
+	{
+		VSync,		// Driver swap interval of 1, no software limiter
+		FixedCap,	// Hybrid sleep/spin limiter at targetFps
+		Uncapped,	// No vsync and no limiter
+		Adaptive	// Vsync at the monitor refresh rate, falls back to the limiter while frames are being missed
+	};
+
+	struct Stats
+	{
+		unsigned long long frames = 0;
+		unsigned long long missedDeadlines = 0;
+
+		double targetFrameTime = 0.0;
+		double lastFrameTime = 0.0;
+		double averageFrameTime = 0.0;
+		double worstFrameTime = 0.0;
+
+		bool isVSyncOn = false;
+	};
+
+	void Initialize(Mode mode, int targetFps);
+	void SetMode(Mode mode, int targetFps);
+	Mode GetMode();
+	const char* GetModeName(Mode mode);
+
+	// Call once per frame right after EndDrawing
+	void EndFrame();
+
+	Stats GetStats();
+	void ResetStats();
+}
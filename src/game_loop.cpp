@@ -6,7 +6,25 @@
 #include "draw.h"
 #include "utils.h"
 #include "button.h"
-
+#include "frame_pacing.h"
+#include "rng.h"
+#include "policy.h"
+#include "world.h"
+#include "snapshot.h"
+#include "netplay.h"
+#include "state_hash.h"
+#include "bindings.h"
+#include "canvas.h"
+#include "parallax.h"
+#include "replay.h"
+#include "telemetry.h"
+#include "high_scores.h"
+#include "tuning.h"
+#include "predictor.h"
+#include "planner.h"
+#include "agent.h"
+
+#include <algorithm>
 #include <iostream>
 
 #include "raylib.h"
@@ -32,8 +50,11 @@ namespace Game
 			static Cursor cursor;
 		}
 
+		static bool showFrameStats = false;
+
 		static void UpdateMousePosition();
-		static void GetDeltaTime();
+		static void UpdateFramePacing();
+		static void DrawFrameStats();
 	}
 
 	namespace Playing
@@ -46,37 +67,16 @@ namespace Game
 			static Sound pause;
 		}
 
-		namespace Parallax
-		{
-			static float scrollingBack = 0.0f;
-			static float scrollingMid = 0.0f;
-			static float scrollingFront = 0.0f;
-
-			static Texture backgroundBackTexture;
-			static Texture backgroundFrontTexture;
-			static Texture backgroundMiddleTexture;
-
-			static void Reset();
-			static void Update();
-			static void Draw();
-		}
-
 		namespace Objects
 		{
-			static Player::Bird bird1;
-			static Player::Bird bird2;
-			static Obstacle::Obstacle obstacle;
+			static World::World world;
+			static Parallax::Layers parallax;
 
 			static Buttons::Button retryButton;
 			static Buttons::Button exitButton;
 			static Buttons::Button resumeButton;
 		}
 
-		enum class Playstyle
-		{
-			Singleplayer, Multiplayer
-		};
-
 		enum class GameplayScene
 		{
 			ReadingRules,
@@ -85,19 +85,106 @@ namespace Game
 			Finished
 		};
 
-		static Playstyle currentPlaystyle = Playstyle::Singleplayer;
+		static World::Playstyle currentPlaystyle = World::Playstyle::Singleplayer;
+
+		// Players sharing the keyboard in multiplayer, changed with left/right on the rules screen
+		static int multiplayerCount = 2;
+
+		// Picked whenever the world is reset, so ticks never look at the player count
+		static World::StepFunction step = World::Update;
 
 		static GameplayScene currentScene = GameplayScene::ReadingRules;
-		static int score = 0;
-		static float timeAlive = 0.0f;
 
-		bool retry = false;
-		bool hasLost = false;
+		// Frame time not yet simulated, and key presses waiting for the next tick
+		static float tickAccumulator = 0.0f;
+		static World::Input pendingInput = 0;
+
+		const float maxFrameTime = 0.25f;
+
+		// Practice runs keep the last few seconds of ticks and can be rewound with R
+		static bool isPractice = false;
+		static Snapshot::RewindBuffer rewind;
+
+		const float rewindOnLoss = 1.0f;
+
+		// Practice can show where each bird goes over the next second with and without a flap, toggled with F6
+		static bool showPaths = false;
+
+		const float pathSeconds = 1.0f;
+		const int pathPoints = 24;
+
+		static StateHash::Log hashLog;
+
+		// Inputs of the current round, written to Externs::replayPath when it ends
+		static Replay::Replay replay;
+
+		// Telemetry of the current round, pushed to the log once it ends
+		static Telemetry::Run run;
+		static bool isRunPending = false;
+		static unsigned long long missedAtRunStart = 0;
+
+		// Place the last round took in the high scores, -1 when it did not make the ranks the menu shows
+		static int highScoreRank = -1;
+
+		// Open when Externs::agentName is set; an outside process sees every tick and its flaps join the local ones
+		static AgentLink::Link agentLink;
+		static Agent::Stats agentStats;
 
 		static void Update();
 		static void Draw();
+		static void Tick(World::Input pressed);
+		static void Rewind();
+		static void DrawPaths();
+		static void SaveReplay();
+		static void BeginRun();
+		static void EndRun();
+		static void RecordHighScore();
+		static World::Input ReadInput();
+		static uint64_t PickSeed();
+		static int GetPlayerCount();
+
+		// Flaps for player 1 by searching ahead, within a small time budget each frame. Playing it takes over the bird,
+		// assisting it only steps in when the bird would otherwise be lost. A trained policy, when there is one, guides the search
+		namespace Autopilot
+		{
+			enum class Mode
+			{
+				Off, Playing, Assisting
+			};
+
+			static Policy::Network champion;
+			static bool hasChampion = false;
+
+			static Mode mode = Mode::Off;
+			static Planner::Planner planner;
+
+			// Attract mode: left idle in the menu, the game plays rounds by itself until a key is pressed
+			static bool isAttracting = false;
+
+			const float attractDelay = 30.0f;
+
+			static void SetMode(Mode newMode);
+			static void StartAttract();
+			static void StopAttract();
+			static bool IsBirdMoving();
+		}
+
+		// Two player rounds against a remote peer; the session owns the tick count and restarts rounds itself
+		namespace Network
+		{
+			static bool isEnabled = false;
+			static Netplay::Config config;
+			static Netplay::Session session;
+
+			static bool isLocalMoving = false;
+
+			// Only confirmed ticks are hashed, predicted ones may still be rolled back
+			static long long hashedTick = 0;
 
-		static bool CheckCollisionsCircleRectangle(float circleX, float circleY, float recX, float recY, float width, float height);
+			static bool IsActive();
+			static void Tick();
+			static void Draw();
+		}
 	}
 
 	namespace Menu
@@ -112,10 +199,14 @@ namespace Game
 		{
 			static Buttons::Button singleplayer;
 			static Buttons::Button multiplayer;
+			static Buttons::Button practice;
 			static Buttons::Button credits;
 			static Buttons::Button exit;
 		}
 
+		// Seconds without input, for the autopilot's attract mode
+		static float idleTime = 0.0f;
+
 		namespace Credits
 		{
 			namespace Objects
@@ -130,6 +221,7 @@ namespace Game
 		static void Update();
 		static void Draw();
 		static void DrawCurrentVer();
+		static void DrawHighScores(int mode, const char* title, int x);
 	}
 
 	enum class State
@@ -145,50 +237,15 @@ namespace Game
 
 	namespace Playing
 	{
-		namespace Parallax
+		void Update()
 		{
-			void Reset()
-			{
-				scrollingBack = 0.0f;
-				scrollingMid = 0.0f;
-				scrollingFront = 0.0f;
-			}
-
-			void Update()
-			{
-				scrollingBack -= 1.0f * Externs::deltaT;
-				scrollingMid -= 2.0f * Externs::deltaT;
-				scrollingFront -= 4.0f * Externs::deltaT;
-
-				if (scrollingBack <= -200.0f)
-				{
-					scrollingBack = 0;
-				}
-				if (scrollingMid <= -200.0f)
-				{
-					scrollingMid = 0;
-				}
-				if (scrollingFront <= -200.0f)
-				{
-					scrollingFront = 0;
-				}
-			}
-
-			void Draw()
+			if (Autopilot::isAttracting && (GetKeyPressed() != 0 || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)))
 			{
-				Draw::DrawSpriteEx(backgroundBackTexture, scrollingBack, 0.0f, 200.0f, 100.0f, 0.0f, WHITE);
-				Draw::DrawSpriteEx(backgroundBackTexture, 200.0f + scrollingBack, 0.0f, 200.0f, 100.0f, 0.0f, WHITE);
-
-				Draw::DrawSpriteEx(backgroundMiddleTexture, scrollingMid, 0.0f, 200.0f, 100.0f, 0.0f, WHITE);
-				Draw::DrawSpriteEx(backgroundMiddleTexture, 200.0f + scrollingMid, 0.0f, 200.0f, 100.0f, 0.0f, WHITE);
-
-				Draw::DrawSpriteEx(backgroundFrontTexture, scrollingFront, 0.0f, 200.0f, 100.0f, 0.0f, WHITE);
-				Draw::DrawSpriteEx(backgroundFrontTexture, 200.0f + scrollingFront, 0.0f, 200.0f, 100.0f, 0.0f, WHITE);
+				// The round is reset when play starts from the menu
+				Autopilot::StopAttract();
+				return;
 			}
-		}
 
-		void Update()
-		{
 			if (currentScene != GameplayScene::ReadingRules)
 			{
 				UpdateMusicStream(Assets::song);
@@ -201,35 +258,30 @@ namespace Game
 			switch (currentScene)
 			{
 			case GameplayScene::ReadingRules:
-				if (IsKeyPressed(KEY_ENTER))
+				if (currentPlaystyle == World::Playstyle::Multiplayer && !Network::isEnabled)
 				{
-					currentScene = GameplayScene::Playing;
-				}
-				break;
-
-			case GameplayScene::Playing:
-
-				timeAlive += Externs::deltaT;
+					int count = multiplayerCount + (IsKeyPressed(KEY_RIGHT) ? 1 : 0) - (IsKeyPressed(KEY_LEFT) ? 1 : 0);
 
-				if (!Objects::obstacle.passed)
-				{
-					if (currentPlaystyle == Playstyle::Singleplayer)
+					if (count >= 2 && count <= World::maxPlayers && count != multiplayerCount)
 					{
-						if (Objects::obstacle.bottom.x < Objects::bird1.position.x)
-						{
-							score += 1;
-							Objects::obstacle.passed = true;
-						}
+						multiplayerCount = count;
+						Objects::world.retry = true;
 					}
-					else
+				}
+
+				if (IsKeyPressed(KEY_ENTER))
+				{
+					if (Network::isEnabled && currentPlaystyle == World::Playstyle::Multiplayer)
 					{
-						if (Objects::obstacle.bottom.x < Objects::bird2.position.x)
-						{
-							score += 1;
-							Objects::obstacle.passed = true;
-						}
+						Netplay::Start(Network::session, Network::config);
+						Network::hashedTick = 0;
 					}
+
+					currentScene = GameplayScene::Playing;
 				}
+				break;
+
+			case GameplayScene::Playing:
 
 				if (IsKeyPressed(KEY_P))
 				{
@@ -237,69 +289,45 @@ namespace Game
 					currentScene = GameplayScene::Pause;
 				}
 
-				Parallax::Update();
-
-				Essentials::GetDeltaTime();
-
-				if (Objects::bird1.isOn)
+				if (Network::IsActive())
 				{
-					Player::Update(Objects::bird1);
+					Parallax::Update(Objects::parallax, GetFrameTime());
+					Network::Tick();
+					break;
 				}
 
-				if (currentPlaystyle == Playstyle::Multiplayer)
+				if (IsKeyPressed(KEY_F5) && !Autopilot::isAttracting)
 				{
-					if (Objects::bird2.isOn)
-					{
-						Player::Update(Objects::bird2);
-					}
-				}
-				else
-				{
-					Objects::bird2.isOn = false;
+					Autopilot::SetMode(Autopilot::mode == Autopilot::Mode::Off ? Autopilot::Mode::Playing : Autopilot::mode == Autopilot::Mode::Playing ? Autopilot::Mode::Assisting : Autopilot::Mode::Off);
 				}
 
-				Obstacle::Update(Objects::obstacle);
+				Parallax::Update(Objects::parallax, GetFrameTime());
+				Telemetry::AddFrame(run, GetFrameTime());
 
-				if (Objects::bird1.isOn)
+				if (isPractice && IsKeyPressed(KEY_F6))
 				{
-					if (CheckCollisionsCircleRectangle(Objects::bird1.position.x, Objects::bird1.position.y, Objects::obstacle.bottom.x,
-						Objects::obstacle.bottom.y, Objects::obstacle.width, Objects::obstacle.height) || CheckCollisionsCircleRectangle
-						(Objects::bird1.position.x, Objects::bird1.position.y, Objects::obstacle.top.x, Objects::obstacle.top.y, Objects::obstacle.width, Objects::obstacle.height))
-					{
-						PlaySound(Assets::hit);
-						Objects::bird1.isOn = false;
-					}
+					showPaths = !showPaths;
 				}
 
-				if (Objects::bird2.isOn)
+				if (isPractice && IsKeyDown(KEY_R))
 				{
-					if (CheckCollisionsCircleRectangle(Objects::bird2.position.x, Objects::bird2.position.y, Objects::obstacle.bottom.x,
-						Objects::obstacle.bottom.y, Objects::obstacle.width, Objects::obstacle.height) || CheckCollisionsCircleRectangle
-						(Objects::bird2.position.x, Objects::bird2.position.y, Objects::obstacle.top.x, Objects::obstacle.top.y, Objects::obstacle.width, Objects::obstacle.height))
-					{
-						PlaySound(Assets::hit);
-						Objects::bird2.isOn = false;
-					}
+					Rewind();
 				}
-
-				if (!Objects::bird1.isOn)
+				else
 				{
-					if (currentPlaystyle == Playstyle::Multiplayer)
-					{
-						if (!Objects::bird2.isOn)
-						{
-							hasLost = true;
-						}
-					}
-					else
-					{
-						hasLost = true;
-					}
+					Tick(ReadInput());
 				}
 
-				if (hasLost)
+				if (Objects::world.hasLost && Autopilot::isAttracting)
+				{
+					Objects::world.retry = true;
+				}
+				else if (Objects::world.hasLost)
 				{
 					currentScene = GameplayScene::Finished;
+					SaveReplay();
+					RecordHighScore();
+					EndRun();
 				}
 
 				break;
@@ -308,13 +336,20 @@ namespace Game
 
 				Essentials::UpdateMousePosition();
 
+				// The peer does not wait for us, so the match keeps going behind the menu
+				if (Network::IsActive())
+				{
+					Network::Tick();
+				}
+
 				if (CheckCollisionPointRec({ Essentials::Objects::cursor.positionX, Essentials::Objects::cursor.positionY }, { Objects::exitButton.position.x - Objects::exitButton.width / 2, Objects::exitButton.position.y - Objects::exitButton.height / 2, Objects::exitButton.width, Objects::exitButton.height }))
 				{
 					Objects::exitButton.text.color = WHITE;
 
 					if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
 					{
-						retry = true;
+						Netplay::Stop(Network::session);
+						Objects::world.retry = true;
 						currentScene = GameplayScene::ReadingRules;
 						currentState = State::Menu;
 					}
@@ -344,6 +379,17 @@ namespace Game
 
 				Essentials::UpdateMousePosition();
 
+				if (isPractice && IsKeyPressed(KEY_R))
+				{
+					Snapshot::Rewind(rewind, Objects::world, static_cast<int>(rewindOnLoss / Objects::world.deltaT));
+					Replay::Truncate(replay, Objects::world.tick);
+					currentScene = GameplayScene::Playing;
+
+					// The round goes on, it gets logged again when it ends
+					run.cause = Telemetry::DeathCause::None;
+					isRunPending = true;
+				}
+
 				if (CheckCollisionPointRec({ Essentials::Objects::cursor.positionX, Essentials::Objects::cursor.positionY }, { Objects::retryButton.position.x - Objects::retryButton.width / 2, Objects::retryButton.position.y - Objects::retryButton.height / 2, Objects::retryButton.width, Objects::retryButton.height }))
 				{
 					Objects::retryButton.text.color = WHITE;
@@ -351,7 +397,7 @@ namespace Game
 					if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
 					{
 						PlaySound(Game::Assets::select);
-						retry = true;
+						Objects::world.retry = true;
 						currentScene = GameplayScene::Playing;
 					}
 				}
@@ -367,7 +413,7 @@ namespace Game
 					if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
 					{
 						currentState = State::Menu;
-						retry = true;
+						Objects::world.retry = true;
 						currentScene = GameplayScene::ReadingRules;
 					}
 				}
@@ -382,17 +428,22 @@ namespace Game
 				break;
 			}
 
-			if (retry)
+			if (Objects::world.retry)
 			{
-				Player::Initialization(Playing::Objects::bird1, KEY_W, { static_cast<float>(Externs::screenWidth) / 6.0f, static_cast<float>(Externs::screenHeight) / 2.0f });
-				Player::Initialization(Playing::Objects::bird2, KEY_UP, { static_cast<float>(Externs::screenWidth) / 5.0f, static_cast<float>(Externs::screenHeight) / 2.0f });
-				Obstacle::Initialization(Playing::Objects::obstacle);
-				Parallax::Reset();
-				score = 0;
-				timeAlive = 0.0f;
+				EndRun();
+				highScoreRank = -1;
+
+				World::Reset(Objects::world, GetPlayerCount(), PickSeed());
+				step = World::GetStep(Objects::world.playerCount);
+				Parallax::Reset(Objects::parallax);
+				Replay::Begin(replay, Objects::world);
+				BeginRun();
+
+				Snapshot::Clear(rewind);
+				Snapshot::Push(rewind, Objects::world);
 
-				retry = false;
-				hasLost = false;
+				tickAccumulator = 0.0f;
+				pendingInput = 0;
 			}
 		}
 
@@ -400,24 +451,41 @@ namespace Game
 		{
 			if (currentScene != GameplayScene::ReadingRules)
 			{
-				Parallax::Draw();
+				Parallax::Draw(Objects::parallax);
 
+				World::Draw(Objects::world);
 
-				Player::Draw(Objects::bird1);
+				if (isPractice && showPaths && !Objects::world.hasLost)
+				{
+					DrawPaths();
+				}
 
+				if (!Objects::world.hasLost)
+				{
+					Canvas::DrawText(TextFormat("%d", (Objects::world.score)), Externs::screenWidth / 2 - Canvas::MeasureText(TextFormat("%d", (Objects::world.score)), 10), Externs::screenHeight / 7, 35, WHITE);
+				}
 
-				if (currentPlaystyle == Playstyle::Multiplayer)
+				if (Autopilot::isAttracting)
+				{
+					DrawText("DEMO - press any key", Externs::screenWidth / 2 - MeasureText("DEMO - press any key", 30) / 2, Externs::screenHeight - 60, 30, WHITE);
+				}
+				else if (Autopilot::mode != Autopilot::Mode::Off)
 				{
+					const char* modeText = Autopilot::mode == Autopilot::Mode::Playing ? "AUTOPILOT" : "ASSIST";
+					DrawText(modeText, Externs::screenWidth - MeasureText(modeText, 20) - 10, 10, 20, WHITE);
+				}
 
-					Player::Draw(Objects::bird2);
+				if (isPractice)
+				{
+					float depth = static_cast<float>(rewind.count) / Snapshot::rewindCapacity;
 
+					DrawText("PRACTICE - hold R to rewind, F6 shows paths", 10, Externs::screenHeight - 40, 20, WHITE);
+					DrawRectangle(10, Externs::screenHeight - 15, static_cast<int>(300 * depth), 6, WHITE);
 				}
 
-				Obstacle::Draw(Objects::obstacle);
-
-				if (!hasLost)
+				if (Network::IsActive())
 				{
-					DrawText(TextFormat("%d", (score)), Externs::screenWidth / 2 - MeasureText(TextFormat("%d", (score)), 10), Externs::screenHeight / 7, 35, WHITE);
+					Network::Draw();
 				}
 			}
 
@@ -426,23 +494,31 @@ namespace Game
 
 			case Game::Playing::GameplayScene::ReadingRules:
 
-				if (currentPlaystyle == Playstyle::Multiplayer)
+				if (currentPlaystyle == World::Playstyle::Multiplayer)
 				{
-					std::string player1Text = "Player1";
-					int player1TextFont = 30;
-					DrawText(player1Text.c_str(), Externs::screenWidth / 2 - 200 - MeasureText(player1Text.c_str(), player1TextFont) / 2, Externs::screenHeight / 2 - 30, player1TextFont, BLACK);
+					int playerCount = GetPlayerCount();
+					int columnWidth = Externs::screenWidth / (playerCount + 1);
 
-					std::string player2Text = "Player2";
-					int player2TextFont = 30;
-					DrawText(player2Text.c_str(), Externs::screenWidth / 2 + 200 - MeasureText(player2Text.c_str(), player2TextFont) / 2, Externs::screenHeight / 2 - 30, player2TextFont, BLACK);
+					for (int i = 0; i < playerCount; i++)
+					{
+						int columnX = columnWidth * (i + 1);
 
-					std::string player1ControlText = "-W to jump";
-					int player1ControlTextFont = 22;
-					DrawText(player1ControlText.c_str(), Externs::screenWidth / 2 - 200 - MeasureText(player1ControlText.c_str(), player1ControlTextFont) / 2, Externs::screenHeight / 2 + 100, player1ControlTextFont, BLACK);
+						std::string playerText = "Player" + std::to_string(i + 1);
+						int playerTextFont = playerCount > 4 ? 24 : 30;
+						DrawText(playerText.c_str(), columnX - MeasureText(playerText.c_str(), playerTextFont) / 2, Externs::screenHeight / 2 - 30, playerTextFont, BLACK);
 
-					std::string player2ControlText = "-Up arrow to jump";
-					int player2ControlTextFont = 22;
-					DrawText(player2ControlText.c_str(), Externs::screenWidth / 2 + 200 - MeasureText(player2ControlText.c_str(), player2ControlTextFont) / 2, Externs::screenHeight / 2 + 100, player2ControlTextFont, BLACK);
+						// Online, whoever plays locally may use either of the first two keys
+						std::string controlText = Network::isEnabled ? (i == Network::config.localPlayer ? "-" + Bindings::players[0].keyName + " or " + Bindings::players[1].keyName + " to jump" : std::string("-Online")) : std::string("-") + Bindings::players[i].keyName + " to jump";
+						int controlTextFont = playerCount > 4 ? 18 : 22;
+						DrawText(controlText.c_str(), columnX - MeasureText(controlText.c_str(), controlTextFont) / 2, Externs::screenHeight / 2 + 100, controlTextFont, BLACK);
+					}
+
+					if (!Network::isEnabled)
+					{
+						std::string countText = "LEFT / RIGHT to change the number of players";
+						int countTextFont = 22;
+						DrawText(countText.c_str(), Externs::screenWidth / 2 - MeasureText(countText.c_str(), countTextFont) / 2, Externs::screenHeight / 2 + 190, countTextFont, BLACK);
+					}
 
 					std::string continueText = "Press ENTER to continue";
 					int continueTextFont = 30;
@@ -464,7 +540,7 @@ namespace Game
 					int player1TextFont = 39;
 					DrawText(player1Text.c_str(), Externs::screenWidth / 2 - MeasureText(player1Text.c_str(), player1TextFont) / 2, Externs::screenHeight / 2 - 50, player1TextFont, BLACK);
 
-					std::string player1ControlText = "-W to jump";
+					std::string player1ControlText = "-" + Bindings::players[0].keyName + " to jump";
 					int player1ControlTextFont = 28;
 					DrawText(player1ControlText.c_str(), Externs::screenWidth / 2 - MeasureText(player1ControlText.c_str(), player1ControlTextFont) / 2, Externs::screenHeight / 2 + 85, player1ControlTextFont, BLACK);
 
@@ -472,6 +548,13 @@ namespace Game
 					int continueTextFont = 30;
 					DrawText(continueText.c_str(), Externs::screenWidth / 2 - MeasureText(continueText.c_str(), continueTextFont) / 2, Externs::screenHeight / 2 + 250, continueTextFont, BLACK);
 
+					if (isPractice)
+					{
+						std::string rewindText = "-Hold R to rewind";
+						int rewindTextFont = 28;
+						DrawText(rewindText.c_str(), Externs::screenWidth / 2 - MeasureText(rewindText.c_str(), rewindTextFont) / 2, Externs::screenHeight / 2 + 125, rewindTextFont, BLACK);
+					}
+
 					std::string rulesText1 = "-Flap your way to the end of an endless magical cave";
 					std::string rulesText2 = "-Avoid hitting rocks or falling off the screen";
 
@@ -495,10 +578,30 @@ namespace Game
 
 			case Playing::GameplayScene::Finished:
 				DrawText("YOU LOST!", Externs::screenWidth / 2 - MeasureText("YOU LOST!", 60) / 2, Externs::screenHeight / 2 - 200, 60, WHITE);
+
+				if (isPractice)
+				{
+					DrawText("Press R to rewind", Externs::screenWidth / 2 - MeasureText("Press R to rewind", 25) / 2, Externs::screenHeight / 2 - 120, 25, WHITE);
+				}
+				else if (highScoreRank >= 0)
+				{
+					const char* rankText = TextFormat("NEW HIGH SCORE - #%d", highScoreRank + 1);
+					DrawText(rankText, Externs::screenWidth / 2 - MeasureText(rankText, 30) / 2, Externs::screenHeight / 2 - 120, 30, GOLD);
+				}
 				Buttons::Draw(Objects::retryButton);
 				Buttons::Draw(Objects::exitButton);
-				DrawText(TextFormat("Score: %d", (score)), Externs::screenWidth / 2 - MeasureText(TextFormat("Score: %d", (score)), 10), Externs::screenHeight / 2, 20, WHITE);
-				DrawText(TextFormat("Seconds alive: %d", static_cast<int>(timeAlive)), Externs::screenWidth / 2 - MeasureText(TextFormat("Seconds alive: %d", static_cast<int>(timeAlive)), 10), Externs::screenHeight / 2 + 35, 20, WHITE);
+				DrawText(TextFormat("Score: %d", (Objects::world.score)), Externs::screenWidth / 2 - MeasureText(TextFormat("Score: %d", (Objects::world.score)), 10), Externs::screenHeight / 2, 20, WHITE);
+				DrawText(TextFormat("Seconds alive: %d", static_cast<int>(Objects::world.timeAlive)), Externs::screenWidth / 2 - MeasureText(TextFormat("Seconds alive: %d", static_cast<int>(Objects::world.timeAlive)), 10), Externs::screenHeight / 2 + 35, 20, WHITE);
+				DrawText(TextFormat("Seed: %016llX", static_cast<unsigned long long>(Objects::world.seed)), Externs::screenWidth / 2 - MeasureText(TextFormat("Seed: %016llX", static_cast<unsigned long long>(Objects::world.seed)), 10), Externs::screenHeight / 2 + 70, 20, WHITE);
+
+				if (Objects::world.playerCount > 1)
+				{
+					for (int i = 0; i < Objects::world.playerCount; i++)
+					{
+						const char* playerScoreText = TextFormat("Player%d: %d", i + 1, Objects::world.scores[i]);
+						DrawText(playerScoreText, Externs::screenWidth * (i + 1) / (Objects::world.playerCount + 1) - MeasureText(playerScoreText, 20) / 2, Externs::screenHeight / 2 + 105, 20, WHITE);
+					}
+				}
 				break;
 
 			default:
@@ -506,23 +609,359 @@ namespace Game
 			}
 		}
 
-		bool CheckCollisionsCircleRectangle(float circleX, float circleY, float recX, float recY, float width, float height)
+		void Tick(World::Input pressed)
+		{
+			pendingInput |= pressed;
+			tickAccumulator = std::min(tickAccumulator + GetFrameTime(), maxFrameTime);
+
+			unsigned int events = 0;
+
+			// One search a frame covers all of its ticks
+			if (Autopilot::mode != Autopilot::Mode::Off && !Objects::world.hasLost)
+			{
+				Planner::Plan(Autopilot::planner, Objects::world);
+			}
+
+			while (tickAccumulator >= Objects::world.deltaT)
+			{
+				World::Input input = pendingInput;
+
+				if (Autopilot::IsBirdMoving())
+				{
+					input |= 1;
+				}
+
+				if (AgentLink::IsOpen(agentLink))
+				{
+					input |= Agent::TakeInput(agentLink, Objects::world, agentStats);
+				}
+
+				// Ticks after a loss change nothing, the replay ends with the tick that lost
+				bool wasLost = Objects::world.hasLost;
+
+				if (!wasLost)
+				{
+					Replay::Record(replay, input);
+				}
+
+				if (Autopilot::mode != Autopilot::Mode::Off)
+				{
+					run.flags |= Telemetry::Flags::autopilot;
+				}
+
+				step(Objects::world, input);
+
+				if (AgentLink::IsOpen(agentLink))
+				{
+					Agent::Publish(agentLink, Objects::world);
+				}
+
+				if (!wasLost && Objects::world.hasLost)
+				{
+					Telemetry::SetDeath(run, Objects::world);
+				}
+				StateHash::Record(hashLog, Objects::world);
+
+				if (isPractice)
+				{
+					Snapshot::Push(rewind, Objects::world);
+				}
+
+				events |= Objects::world.events;
+				pendingInput = 0;
+				tickAccumulator -= Objects::world.deltaT;
+			}
+
+			if (events & World::Events::flap)
+			{
+				Player::PlayFlapSound();
+			}
+
+			if (events & World::Events::fall)
+			{
+				Player::PlayFallSound();
+			}
+
+			if (events & World::Events::hit)
+			{
+				PlaySound(Assets::hit);
+			}
+		}
+
+		void Rewind()
+		{
+			// Rewinds at the same speed time passed, and drops presses made while holding R
+			tickAccumulator = std::min(tickAccumulator + GetFrameTime(), maxFrameTime);
+			pendingInput = 0;
+
+			int ticks = static_cast<int>(tickAccumulator / Objects::world.deltaT);
+
+			tickAccumulator -= ticks * Objects::world.deltaT;
+			int rewound = Snapshot::Rewind(rewind, Objects::world, ticks);
+			Replay::Truncate(replay, Objects::world.tick);
+
+			// Answers to the ticks rewound over would land on the same ticks replayed
+			if (rewound > 0 && AgentLink::IsOpen(agentLink))
+			{
+				AgentLink::DropActions(agentLink);
+				Agent::Publish(agentLink, Objects::world);
+			}
+		}
+
+		void DrawPaths()
+		{
+			const World::World& world = Objects::world;
+			Vector2 points[pathPoints];
+
+			for (int i = 0; i < world.playerCount; i++)
+			{
+				if (!world.birds[i].isOn)
+				{
+					continue;
+				}
+
+				// Flapping in gold, falling in white, dots spaced out in time like the obstacles will be
+				for (int isFlapping = 0; isFlapping < 2; isFlapping++)
+				{
+					int count = Predictor::GetPath(world.birds[i], isFlapping != 0, pathSeconds, world.deltaT, world.obstacle.velocity, points, pathPoints);
+					Color color = isFlapping ? Color{ 255, 203, 0, 200 } : Color{ 255, 255, 255, 160 };
+
+					for (int point = 0; point < count; point++)
+					{
+						Canvas::DrawCircle(points[point], 3.0f, color);
+					}
+				}
+			}
+		}
+
+		void SaveReplay()
+		{
+			if (Externs::replayPath.empty())
+			{
+				return;
+			}
+
+			Replay::Finish(replay, Objects::world);
+
+			if (!Replay::Save(replay, Externs::replayPath))
+			{
+				std::cerr << "could not write " << Externs::replayPath << "\n";
+			}
+		}
+
+		void BeginRun()
+		{
+			uint8_t flags = 0;
+
+			if (isPractice)
+			{
+				flags |= Telemetry::Flags::practice;
+			}
+
+			if (Externs::isDailyChallenge)
+			{
+				flags |= Telemetry::Flags::dailyChallenge;
+			}
+
+			Telemetry::Begin(run, Objects::world, flags);
+
+			// Ticks start over, so the agent's answers to the last round would hold back this one's; it gets the first tick
+			// of the round too, not just the ones after it
+			if (AgentLink::IsOpen(agentLink))
+			{
+				AgentLink::DropActions(agentLink);
+				Agent::Publish(agentLink, Objects::world);
+			}
+
+			missedAtRunStart = FramePacing::GetStats().missedDeadlines;
+			isRunPending = true;
+		}
+
+		void EndRun()
+		{
+			// Rounds left before their first tick, like on the rules screen, are not runs
+			if (!isRunPending || Objects::world.tick == 0)
+			{
+				return;
+			}
+
+			Telemetry::Finish(run, Objects::world, static_cast<uint32_t>(FramePacing::GetStats().missedDeadlines - missedAtRunStart));
+			Telemetry::Push(run);
+			isRunPending = false;
+		}
+
+		void RecordHighScore()
+		{
+			// Rewinds and the autopilot make for scores nobody earned, and a round that never scored is no high score
+			if (isPractice || (run.flags & Telemetry::Flags::autopilot) || Objects::world.score <= 0)
+			{
+				return;
+			}
+
+			HighScores::Entry entry = {};
+			entry.score = Objects::world.score;
+			entry.timeAlive = Objects::world.timeAlive;
+			entry.seed = Objects::world.seed;
+			entry.time = run.startTime;
+			entry.playerCount = static_cast<uint32_t>(Objects::world.playerCount);
+
+			int rank = HighScores::Insert(static_cast<int>(currentPlaystyle), entry);
+
+			// The rest of the table is kept, just not shown
+			highScoreRank = rank < HighScores::shownCount ? rank : -1;
+		}
+
+		World::Input ReadInput()
+		{
+			World::Input input = Bindings::Read(Objects::world.playerCount);
+
+			if (Autopilot::mode == Autopilot::Mode::Playing)
+			{
+				input &= static_cast<World::Input>(~1);
+			}
+
+			return input;
+		}
+
+		uint64_t PickSeed()
+		{
+			if (Externs::seed != 0)
+			{
+				return Externs::seed;
+			}
+
+			if (Externs::isDailyChallenge)
+			{
+				return Rng::DailySeed();
+			}
+
+			return Rng::RandomSeed();
+		}
+
+		int GetPlayerCount()
+		{
+			if (currentPlaystyle == World::Playstyle::Singleplayer)
+			{
+				return 1;
+			}
+
+			return Network::isEnabled ? Netplay::playerCount : multiplayerCount;
+		}
+
+		namespace Autopilot
 		{
-			const float circleRadius = 30.0f;
+			void SetMode(Mode newMode)
+			{
+				Planner::Config config;
+				config.isAssisting = newMode == Mode::Assisting;
+
+				mode = newMode;
+				Planner::Reset(planner, config, 0, hasChampion ? &champion : nullptr);
+			}
+
+			void StartAttract()
+			{
+				isAttracting = true;
+				SetMode(Mode::Playing);
+
+				currentState = State::Playing;
+				currentPlaystyle = World::Playstyle::Singleplayer;
+				currentScene = GameplayScene::Playing;
+				isPractice = false;
+				Objects::world.retry = true;
+			}
+
+			void StopAttract()
+			{
+				isAttracting = false;
+				SetMode(Mode::Off);
+
+				currentState = State::Menu;
+				currentScene = GameplayScene::ReadingRules;
+				Objects::world.retry = true;
+			}
+
+			bool IsBirdMoving()
+			{
+				return mode != Mode::Off && Planner::IsBirdMoving(planner, Objects::world);
+			}
+		}
+
+		namespace Network
+		{
+			bool IsActive()
+			{
+				return isEnabled && session.isOpen;
+			}
+
+			void Tick()
+			{
+				// Player 1 or player 2 keys flap the local bird, whichever side of the keyboard the player sits on
+				isLocalMoving = isLocalMoving || Bindings::Read(2) != 0;
+				tickAccumulator = std::min(tickAccumulator + GetFrameTime(), maxFrameTime);
+
+				unsigned int events = 0;
+
+				Netplay::Poll(session, Objects::world);
+
+				// A stall leaves the time in the accumulator, so we catch up once the peer's inputs arrive
+				while (tickAccumulator >= Objects::world.deltaT && Netplay::Update(session, Objects::world, isLocalMoving))
+				{
+					events |= Objects::world.events;
+					isLocalMoving = false;
+					tickAccumulator -= Objects::world.deltaT;
+				}
 
-			float closestX = std::max(recX, std::min(circleX, recX + width));
-			float closestY = std::max(recY, std::min(circleY, recY + height));
+				// Poll and Update leave no rollback pending, but a state past one would still be a guess
+				for (; session.isRunning && hashedTick <= Netplay::GetConfirmedTick(session) && (session.rollbackTo < 0 || hashedTick < session.rollbackTo); hashedTick++)
+				{
+					// The snapshot before each confirmed tick, restored into a scratch copy to hash
+					World::World confirmed = Objects::world;
+					Snapshot::Restore(confirmed, session.states[hashedTick % Netplay::historySize]);
+
+					StateHash::Record(hashLog, confirmed);
+				}
+
+				if (events & World::Events::flap)
+				{
+					Player::PlayFlapSound();
+				}
 
-			float distanceX = circleX - closestX;
-			float distanceY = circleY - closestY;
+				if (events & World::Events::fall)
+				{
+					Player::PlayFallSound();
+				}
 
-			float distanceSquared = (distanceX * distanceX) + (distanceY * distanceY);
+				if (events & World::Events::hit)
+				{
+					PlaySound(Assets::hit);
+				}
+			}
 
-			if (distanceSquared < (circleRadius * circleRadius))
+			void Draw()
 			{
-				return true;
+				if (!session.isRunning)
+				{
+					const char* waitingText = TextFormat("Waiting for the other player on port %d...", static_cast<int>(config.localPort));
+					DrawText(waitingText, Externs::screenWidth / 2 - MeasureText(waitingText, 30) / 2, Externs::screenHeight / 2 - 100, 30, WHITE);
+					return;
+				}
+
+				DrawText(config.localPlayer == 0 ? "YOU ARE PLAYER 1" : "YOU ARE PLAYER 2", 10, Externs::screenHeight - 40, 20, WHITE);
+
+				if (Objects::world.hasLost)
+				{
+					DrawText("ROUND OVER", Externs::screenWidth / 2 - MeasureText("ROUND OVER", 60) / 2, Externs::screenHeight / 2 - 200, 60, WHITE);
+				}
+
+				if (Essentials::showFrameStats)
+				{
+					const Netplay::Stats& stats = session.stats;
+
+					DrawText(TextFormat("remote lag %d ticks  rollbacks %llu  last %d  max %d ticks", stats.remoteLag, stats.rollbacks, stats.lastRollbackTicks, stats.maxRollbackTicks), 10, 85, 20, DARKGREEN);
+					DrawText(TextFormat("resimulation last %.3f ms  max %.3f ms  stalls %llu", stats.lastResimulateMs, stats.maxResimulateMs, stats.stalls), 10, 110, 20, DARKGREEN);
+				}
 			}
-			return false;
 		}
 	}
 
@@ -532,6 +971,24 @@ namespace Game
 		{
 			Essentials::UpdateMousePosition();
 
+			Vector2 mouseDelta = GetMouseDelta();
+
+			if (GetKeyPressed() != 0 || IsMouseButtonPressed(MOUSE_LEFT_BUTTON) || mouseDelta.x != 0.0f || mouseDelta.y != 0.0f)
+			{
+				idleTime = 0.0f;
+			}
+			else
+			{
+				idleTime += GetFrameTime();
+			}
+
+			if (idleTime > Playing::Autopilot::attractDelay)
+			{
+				idleTime = 0.0f;
+				Playing::Autopilot::StartAttract();
+				return;
+			}
+
 			Rectangle singleplayerButt = { Objects::singleplayer.position.x - Objects::singleplayer.width / 2, Objects::singleplayer.position.y - Objects::singleplayer.height / 2, Objects::singleplayer.width, Objects::singleplayer.height };
 
 			if (CheckCollisionPointRec({ Essentials::Objects::cursor.positionX, Essentials::Objects::cursor.positionY }, singleplayerButt))
@@ -542,7 +999,9 @@ namespace Game
 				{
 					PlaySound(Game::Assets::select);
 					currentState = State::Playing;
-					Playing::currentPlaystyle = Playing::Playstyle::Singleplayer;
+					Playing::currentPlaystyle = World::Playstyle::Singleplayer;
+					Playing::isPractice = false;
+					Playing::Objects::world.retry = true;
 				}
 			}
 			else
@@ -560,7 +1019,9 @@ namespace Game
 				{
 					PlaySound(Game::Assets::select);
 					currentState = State::Playing;
-					Playing::currentPlaystyle = Playing::Playstyle::Multiplayer;
+					Playing::currentPlaystyle = World::Playstyle::Multiplayer;
+					Playing::isPractice = false;
+					Playing::Objects::world.retry = true;
 				}
 			}
 			else
@@ -568,6 +1029,26 @@ namespace Game
 				Objects::multiplayer.text.color = GRAY;
 			}
 
+			Rectangle practiceButt = { Objects::practice.position.x - Objects::practice.width / 2, Objects::practice.position.y - Objects::practice.height / 2, Objects::practice.width, Objects::practice.height };
+
+			if (CheckCollisionPointRec({ Essentials::Objects::cursor.positionX, Essentials::Objects::cursor.positionY }, practiceButt))
+			{
+				Objects::practice.text.color = WHITE;
+
+				if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+				{
+					PlaySound(Game::Assets::select);
+					currentState = State::Playing;
+					Playing::currentPlaystyle = World::Playstyle::Singleplayer;
+					Playing::isPractice = true;
+					Playing::Objects::world.retry = true;
+				}
+			}
+			else
+			{
+				Objects::practice.text.color = GRAY;
+			}
+
 			Rectangle creditsButt = { Objects::credits.position.x - Objects::credits.width / 2,Objects::credits.position.y - Objects::credits.height / 2, Objects::credits.width, Objects::credits.height };
 
 			if (CheckCollisionPointRec({ Essentials::Objects::cursor.positionX, Essentials::Objects::cursor.positionY }, creditsButt))
@@ -605,29 +1086,26 @@ namespace Game
 		{
 			Buttons::Draw(Objects::singleplayer);
 			Buttons::Draw(Objects::multiplayer);
+			Buttons::Draw(Objects::practice);
 			Buttons::Draw(Objects::credits);
 			Buttons::Draw(Objects::exit);
 
+			DrawHighScores(static_cast<int>(World::Playstyle::Singleplayer), "BEST - SINGLEPLAYER", 40);
+			DrawHighScores(static_cast<int>(World::Playstyle::Multiplayer), "BEST - MULTIPLAYER", Externs::screenWidth - 300);
+
 			DrawCurrentVer();
 		}
 
-		bool CheckCollisionsCircleRectangle(float circleX, float circleY, float recX, float recY, float width, float height)
+		void DrawHighScores(int mode, const char* title, int x)
 		{
-			const float circleRadius = 30.0f;
-
-			float closestX = std::max(recX, std::min(circleX, recX + width));
-			float closestY = std::max(recY, std::min(circleY, recY + height));
+			const HighScores::Table& table = HighScores::GetTable(mode);
 
-			float distanceX = circleX - closestX;
-			float distanceY = circleY - closestY;
+			DrawText(title, x, Externs::screenHeight / 3, 20, BLACK);
 
-			float distanceSquared = (distanceX * distanceX) + (distanceY * distanceY);
-
-			if (distanceSquared < (circleRadius * circleRadius))
+			for (int i = 0; i < HighScores::shownCount && i < static_cast<int>(table.count); i++)
 			{
-				return true;
+				DrawText(TextFormat("%d. %d", i + 1, table.entries[i].score), x, Externs::screenHeight / 3 + 30 * (i + 1), 20, DARKGRAY);
 			}
-			return false;
 		}
 
 		void DrawCurrentVer()
@@ -704,12 +1182,42 @@ namespace Game
 			Objects::cursor.positionY = Utils::PixelsToPercentY(GetMousePosition().y);
 		};
 
-		void GetDeltaTime()
+		void UpdateFramePacing()
+		{
+			if (IsKeyPressed(KEY_F2))
+			{
+				FramePacing::Mode next = static_cast<FramePacing::Mode>((static_cast<int>(FramePacing::GetMode()) + 1) % 4);
+				FramePacing::SetMode(next, Externs::targetFps);
+				FramePacing::ResetStats();
+			}
+
+			if (IsKeyPressed(KEY_F3))
+			{
+				showFrameStats = !showFrameStats;
+			}
+		}
+
+		void DrawFrameStats()
 		{
-			Externs::deltaT = GetFrameTime();
+			if (!showFrameStats)
+			{
+				return;
+			}
+
+			FramePacing::Stats stats = FramePacing::GetStats();
+
+			DrawText(TextFormat("%s%s  target %.2f ms", FramePacing::GetModeName(FramePacing::GetMode()), stats.isVSyncOn ? " (vsync)" : "", stats.targetFrameTime * 1000.0), 10, 10, 20, DARKGREEN);
+			DrawText(TextFormat("last %.2f ms  avg %.2f ms  worst %.2f ms", stats.lastFrameTime * 1000.0, stats.averageFrameTime * 1000.0, stats.worstFrameTime * 1000.0), 10, 35, 20, DARKGREEN);
+			DrawText(TextFormat("missed %llu / %llu frames", stats.missedDeadlines, stats.frames), 10, 60, 20, DARKGREEN);
 		}
 	}
 
+	void EnableNetplay(const Netplay::Config& config)
+	{
+		Playing::Network::isEnabled = true;
+		Playing::Network::config = config;
+	}
+
 	void Initialize()
 	{
 		float buttonWidth = 25.0f;
@@ -723,20 +1231,56 @@ namespace Game
 		Menu::Objects::multiplayer.text.text = "MULTIPLAYER";
 		Buttons::Initialize(Menu::Objects::multiplayer, buttonWidth, buttonHeight, buttonCenterX, 35.0f);
 
+		Menu::Objects::practice.text.text = "PRACTICE";
+		Buttons::Initialize(Menu::Objects::practice, buttonWidth, buttonHeight, buttonCenterX, 45.0f);
+
 		//credits.text.font = externs::defaultText.font;
 		Menu::Objects::credits.text.text = "CREDITS";
-		Buttons::Initialize(Menu::Objects::credits, buttonWidth, buttonHeight, buttonCenterX, 45.0f);
+		Buttons::Initialize(Menu::Objects::credits, buttonWidth, buttonHeight, buttonCenterX, 55.0f);
 
 		//exit.text.font = externs::defaultText.font;
 		Menu::Objects::exit.text.text = "EXIT";
-		Buttons::Initialize(Menu::Objects::exit, buttonWidth, buttonHeight, buttonCenterX, 55.0f);
+		Buttons::Initialize(Menu::Objects::exit, buttonWidth, buttonHeight, buttonCenterX, 65.0f);
 
 		Menu::Credits::Objects::returnButton.text.text = "EXIT";
 		Buttons::Initialize(Menu::Credits::Objects::returnButton, buttonWidth, buttonHeight, buttonCenterX, 55.0f);
 
-		Player::Initialization(Playing::Objects::bird1, KEY_W, { static_cast<float>(Externs::screenWidth) / 6.0f, static_cast<float>(Externs::screenHeight) / 2.0f });
-		Player::Initialization(Playing::Objects::bird2, KEY_UP, { static_cast<float>(Externs::screenWidth) / 5.0f, static_cast<float>(Externs::screenHeight) / 2.0f });
-		Obstacle::Initialization(Playing::Objects::obstacle);
+		if (!Tuning::Watch(Externs::tuningPath, Externs::tuningCachePath))
+		{
+			std::cerr << "could not read tuning " << Externs::tuningPath << ", using the defaults\n";
+		}
+
+		if (!Bindings::Load(Externs::bindingsPath))
+		{
+			std::cerr << "could not read key bindings " << Externs::bindingsPath << ", using the defaults\n";
+		}
+
+		World::Reset(Playing::Objects::world, Playing::GetPlayerCount(), Playing::PickSeed());
+		Replay::Begin(Playing::replay, Playing::Objects::world);
+		Player::LoadSounds();
+
+		Playing::Autopilot::hasChampion = Policy::Load(Playing::Autopilot::champion, Externs::championPolicy);
+
+		if (!Externs::hashLogPath.empty() && !StateHash::Open(Playing::hashLog, Externs::hashLogPath, true))
+		{
+			std::cerr << "could not write " << Externs::hashLogPath << "\n";
+		}
+
+		if (!Externs::telemetryPath.empty() && !Telemetry::Start(Externs::telemetryPath))
+		{
+			std::cerr << "could not append to " << Externs::telemetryPath << "\n";
+		}
+
+		if (!Externs::agentName.empty() && !AgentLink::Create(Playing::agentLink, Externs::agentName))
+		{
+			std::cerr << "could not create the agent link " << Externs::agentName << "\n";
+		}
+
+		// Without the file scores are still kept for the session
+		if (!HighScores::Open(Externs::highScorePath))
+		{
+			std::cerr << "could not open high scores " << Externs::highScorePath << "\n";
+		}
 
 		Playing::Objects::exitButton.text.text = "EXIT";
 		Buttons::Initialize(Playing::Objects::exitButton, buttonWidth, buttonHeight, buttonCenterX - 14, 80.0f);
@@ -747,11 +1291,7 @@ namespace Game
 		Playing::Objects::resumeButton.text.text = "RESUME";
 		Buttons::Initialize(Playing::Objects::resumeButton, buttonWidth, buttonHeight, buttonCenterX + 10, 80.0f);
 
-		Playing::Parallax::backgroundFrontTexture = LoadTexture(Externs::backgroundFrontTexture.c_str());
-
-		Playing::Parallax::backgroundMiddleTexture = LoadTexture(Externs::backgroundMiddleTexture.c_str());
-
-		Playing::Parallax::backgroundBackTexture = LoadTexture(Externs::backgroundBackTexture.c_str());
+		Parallax::Load();
 
 		Playing::Assets::song = LoadMusicStream(Externs::playingSong.c_str());
 		PlayMusicStream(Playing::Assets::song);
@@ -770,9 +1310,7 @@ namespace Game
 
 	void UnloadTextures()
 	{
-		UnloadTexture(Playing::Parallax::backgroundFrontTexture);
-		UnloadTexture(Playing::Parallax::backgroundMiddleTexture);
-		UnloadTexture(Playing::Parallax::backgroundBackTexture);
+		Parallax::Unload();
 	}
 
 	void UnloadSounds()
@@ -789,10 +1327,20 @@ namespace Game
 		InitWindow(Externs::screenWidth, Externs::screenHeight, "Flappy Bird");
 		InitAudioDevice();
 
+		FramePacing::Initialize(Externs::framePacingMode, Externs::targetFps);
+
 		Initialize();
 
 		while (!WindowShouldClose() && currentState != State::Exit)
 		{
+			Essentials::UpdateFramePacing();
+
+			// Between frames is between ticks. A netplay peer would not see the change, so it waits for the match to end
+			if (!Playing::Network::IsActive())
+			{
+				Tuning::Poll();
+			}
+
 			switch (currentState)
 			{
 			case State::Menu:
@@ -846,9 +1394,22 @@ namespace Game
 				break;
 			}
 
+			Essentials::DrawFrameStats();
+
 			EndDrawing();
+
+			FramePacing::EndFrame();
 		}
 
+		Netplay::Stop(Playing::Network::session);
+		StateHash::Close(Playing::hashLog);
+		AgentLink::Close(Playing::agentLink);
+
+		Playing::EndRun();
+		Telemetry::Stop();
+		HighScores::Close();
+		Tuning::Unwatch();
+
 		UnloadSounds();
 		UnloadTextures();
 
@@ -1,6 +1,10 @@
 #pragma once
+#include "netplay.h"
 
 namespace Game
 {
+	// Multiplayer then plays against a peer over UDP instead of sharing the keyboard
+	void EnableNetplay(const Netplay::Config& config);
+
 	void GameLoop();
 }
\ No newline at end of file
@@ -2,11 +2,24 @@
 
 namespace Externs
 {
-	float deltaT;
-
 	int screenWidth = 1250;
 	int screenHeight = 768;
 
+	FramePacing::Mode framePacingMode = FramePacing::Mode::Adaptive;
+	int targetFps = 144;
+
+	uint64_t seed = 0;
+	bool isDailyChallenge = false;
+
+	std::string hashLogPath;
+	std::string replayPath;
+	std::string telemetryPath = "telemetry.bin";
+	std::string agentName;
+	std::string highScorePath = "highscores.bin";
+	std::string tuningPath = "res/tuning.cfg";
+	std::string tuningCachePath = "tuning.cache";
+	std::string bindingsPath = "res/bindings.cfg";
+
 	std::string backgroundFrontTexture = "res/sprites/background/placeholder_front.png";
 
 	std::string backgroundMiddleTexture = "res/sprites/background/placeholder_middle.png";
@@ -26,4 +39,6 @@ namespace Externs
 	std::string birdHitSound = "res/sounds/sfx/bird_hit.mp3";
 
 	std::string birdFallSound = "res/sounds/sfx/bird_fall.mp3";
+
+	std::string championPolicy = "res/bots/champion.policy";
 }
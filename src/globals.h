@@ -1,13 +1,44 @@
 #pragma once
+#include <cstdint>
 #include <string>
 
+#include "frame_pacing.h"
+
 namespace Externs
 {
-	extern float deltaT;
-
 	extern int screenWidth;
 	extern int screenHeight;
 
+	extern FramePacing::Mode framePacingMode;
+	extern int targetFps;
+
+	// 0 picks a fresh seed every run
+	extern uint64_t seed;
+	// Every run of the day uses the same seed, the same for every player; set with --daily
+	extern bool isDailyChallenge;
+
+	// Empty turns it off; otherwise every simulated tick is hashed into this file for hash-diff
+	extern std::string hashLogPath;
+
+	// Empty turns it off; otherwise every finished local round is written here as a replay
+	extern std::string replayPath;
+
+	// Empty turns it off; otherwise a record of every round is appended to this file
+	extern std::string telemetryPath;
+
+	// Empty turns it off; otherwise an outside process can play through shared memory under this name
+	extern std::string agentName;
+
+	extern std::string highScorePath;
+
+	// Gameplay constants, reloaded whenever the file changes
+	extern std::string tuningPath;
+	// Binary image of the parsed constants; empty parses the text on every start
+	extern std::string tuningCachePath;
+
+	// Flap key of each player
+	extern std::string bindingsPath;
+
 	extern std::string backgroundFrontTexture;
 
 	extern std::string backgroundMiddleTexture;
@@ -27,9 +58,6 @@ namespace Externs
 	extern std::string birdHitSound;
 
 	extern std::string birdFallSound;
-}
 
-namespace Globals
-{
-	const float acceleration = 981.0f;
+	extern std::string championPolicy;
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "hash_log.h"
+
+#include <iomanip>
+#include <iostream>
+
+#include "state_hash.h"
+
+namespace HashLog
+{
+	int Run(const Config& config)
+	{
+		StateHash::Log log;
+
+		if (!StateHash::Open(log, config.outputPath, config.hasFields))
+		{
+			std::cerr << "could not write " << config.outputPath << "\n";
+			return 1;
+		}
+
+		World::World world;
+		World::Reset(world, config.playerCount, config.seed);
+		world.deltaT = config.deltaT;
+
+		Rng::Rng inputRng;
+		Rng::Seed(inputRng, config.seed, 1);
+
+		World::StepFunction step = World::GetStep(world.playerCount);
+
+		int rounds = 1;
+
+		for (int tick = 0; tick < config.ticks; tick++)
+		{
+			World::Input input = 0;
+
+			for (int player = 0; player < world.playerCount; player++)
+			{
+				if (Rng::Float(inputRng) < config.flapChance)
+				{
+					input |= static_cast<World::Input>(1 << player);
+				}
+			}
+
+			step(world, input);
+			StateHash::Record(log, world);
+
+			if (world.hasLost)
+			{
+				World::Reset(world, config.playerCount, Rng::Next(world.rng));
+				world.deltaT = config.deltaT;
+				rounds++;
+			}
+		}
+
+		StateHash::Close(log);
+
+		std::cout << config.ticks << " ticks over " << rounds << " rounds, chained hash " << std::hex << std::setw(16) << std::setfill('0') << log.chain << std::dec << "\n";
+
+		return 0;
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "world.h"
+
+namespace HashLog
+{
+	struct Config
+	{
+		int ticks = 36000;
+		float deltaT = World::defaultDeltaT;
+		int playerCount = 2;
+
+		// Each bird flaps with this chance every tick, drawn from its own stream of the seed
+		float flapChance = 0.06f;
+
+		uint64_t seed = 1;
+
+		std::string outputPath = "hashes.txt";
+		bool hasFields = true;
+	};
+
+	// Plays scripted rounds back to back and logs the state hash of every tick, so builds can be compared with hash-diff
+	int Run(const Config& config);
+}
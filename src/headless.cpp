@@ -0,0 +1,145 @@
+#include "headless.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "canvas.h"
+#include "globals.h"
+#include "job_system.h"
+
+namespace Headless
+{
+	void RecordFrame(SoftRender::Frame& frame, const World::World& world, const Parallax::Layers& parallax, int width, int height)
+	{
+		SoftRender::Begin(frame, width, height, RAYWHITE);
+		SoftRender::SetScale(frame, static_cast<float>(width) / Externs::screenWidth, static_cast<float>(height) / Externs::screenHeight);
+
+		SoftRender::Frame* previous = Canvas::GetTarget();
+		Canvas::SetTarget(&frame);
+
+		Parallax::Draw(parallax);
+		World::Draw(world);
+
+		if (!world.hasLost)
+		{
+			const std::string score = std::to_string(world.score);
+			Canvas::DrawText(score.c_str(), Externs::screenWidth / 2 - Canvas::MeasureText(score.c_str(), 10), Externs::screenHeight / 7, 35, WHITE);
+		}
+
+		Canvas::SetTarget(previous);
+	}
+
+	int Run(const Config& config)
+	{
+		Jobs::Initialize(config.threadCount, config.pinThreads);
+		Parallax::Load();
+
+		World::World world;
+		World::Reset(world, config.playerCount, config.seed);
+
+		Parallax::Layers parallax;
+		Parallax::Reset(parallax);
+
+		Rng::Rng inputRng;
+		Rng::Seed(inputRng, config.seed, 1);
+
+		SoftRender::Frame frame;
+		SoftRender::Framebuffer framebuffer;
+
+		const float frameTime = 1.0f / 60.0f;
+		const int ticksPerFrame = std::max(1, static_cast<int>(frameTime / world.deltaT + 0.5f));
+
+		double totalMs = 0.0;
+		double worstMs = 0.0;
+		double bestMs = 1e9;
+
+		for (int i = 0; i < config.frames; i++)
+		{
+			for (int tick = 0; tick < ticksPerFrame; tick++)
+			{
+				World::Input input = 0;
+
+				for (int player = 0; player < world.playerCount; player++)
+				{
+					// Flaps whenever a bird sinks below the middle, with some noise so they do not all move alike
+					const Player::Bird& bird = world.birds[player];
+
+					if (bird.position.y > Externs::screenHeight * 0.5f && bird.velocity < 0.0f && Rng::Float(inputRng) < 0.3f)
+					{
+						input |= static_cast<World::Input>(1 << player);
+					}
+				}
+
+				World::Update(world, input);
+			}
+
+			Parallax::Update(parallax, frameTime);
+
+			if (world.hasLost)
+			{
+				World::Reset(world, config.playerCount, Rng::Next(world.rng));
+			}
+
+			auto start = std::chrono::steady_clock::now();
+
+			RecordFrame(frame, world, parallax, Externs::screenWidth, Externs::screenHeight);
+			SoftRender::Render(frame, framebuffer, config.tileSize);
+
+			double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			totalMs += elapsed;
+			worstMs = std::max(worstMs, elapsed);
+			bestMs = std::min(bestMs, elapsed);
+		}
+
+		Parallax::Unload();
+
+		std::cout << config.frames << " frames at " << framebuffer.width << "x" << framebuffer.height << " on " << Jobs::GetThreadCount() << " threads: "
+			<< totalMs / std::max(config.frames, 1) << " ms average, " << bestMs << " ms best, " << worstMs << " ms worst\n";
+
+		Jobs::Shutdown();
+
+		if (!config.outputPath.empty() && !SoftRender::SavePpm(framebuffer, config.outputPath))
+		{
+			std::cerr << "could not write " << config.outputPath << "\n";
+			return 1;
+		}
+
+		if (config.goldenPath.empty())
+		{
+			return 0;
+		}
+
+		if (config.isUpdatingGolden)
+		{
+			if (!SoftRender::SavePpm(framebuffer, config.goldenPath))
+			{
+				std::cerr << "could not write " << config.goldenPath << "\n";
+				return 1;
+			}
+
+			std::cout << "golden image written to " << config.goldenPath << "\n";
+			return 0;
+		}
+
+		SoftRender::Framebuffer golden;
+
+		if (!SoftRender::LoadPpm(golden, config.goldenPath))
+		{
+			std::cerr << "could not read " << config.goldenPath << "\n";
+			return 1;
+		}
+
+		long long differences = SoftRender::CountDifferences(framebuffer, golden, config.tolerance);
+
+		if (differences != 0)
+		{
+			std::cout << "golden image mismatch: " << (differences < 0 ? "different size" : std::to_string(differences) + " pixels differ") << "\n";
+			return 1;
+		}
+
+		std::cout << "matches golden image\n";
+		return 0;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "parallax.h"
+#include "soft_render.h"
+#include "world.h"
+
+namespace Headless
+{
+	// Records what Playing::Draw shows during play (background, birds, obstacle, score) into a software frame,
+	// scaled from the screen size to width by height
+	void RecordFrame(SoftRender::Frame& frame, const World::World& world, const Parallax::Layers& parallax, int width, int height);
+
+	struct Config
+	{
+		int frames = 240;
+		int playerCount = 2;
+		int threadCount = 0;
+		bool pinThreads = false;
+		int tileSize = SoftRender::defaultTileSize;
+
+		uint64_t seed = 1;
+
+		// Last frame is written here as a PPM when set
+		std::string outputPath;
+
+		// Last frame is compared against this PPM, or written to it when isUpdatingGolden
+		std::string goldenPath;
+		bool isUpdatingGolden = false;
+		int tolerance = 0;
+	};
+
+	// Plays a scripted game at 60 frames per second, rendering every frame on the CPU and timing it
+	int Run(const Config& config);
+}
@@ -0,0 +1,333 @@
+#include "heatmap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "globals.h"
+#include "job_system.h"
+#include "soft_render.h"
+#include "telemetry.h"
+
+namespace Heatmap
+{
+	struct Axis
+	{
+		float min;
+		float max;
+	};
+
+	// Per worker counts, merged once the whole log is binned
+	struct Histograms
+	{
+		std::vector<unsigned long long> aroundObstacle;
+		std::vector<unsigned long long> byGap;
+		std::vector<unsigned long long> velocity;
+
+		unsigned long long deaths = 0;
+		unsigned long long outOfRange = 0;
+		double gapHeight = 0.0;
+
+		// Workers' histograms sit next to each other in a vector
+		char padding[64];
+	};
+
+	namespace Axes
+	{
+		// Distance of the bird past the obstacle's left edge, and bird height minus the gap center
+		static const Axis pastObstacle = { -600.0f, 200.0f };
+		static const Axis fromGapCenter = { -400.0f, 400.0f };
+
+		static Axis GetGapCenter();
+		static Axis GetBirdHeight();
+
+		static const Axis velocity = { -1200.0f, 600.0f };
+		const int velocityBins = 18;
+	}
+
+	static int GetBin(float value, Axis axis, int bins);
+	static void Add(Histograms& histograms, const Telemetry::Run& run, int bins);
+	static void Merge(Histograms& total, const Histograms& worker);
+
+	static uint32_t GetHeatColor(float heat);
+	static SoftRender::Image Draw(const std::vector<unsigned long long>& counts, int bins);
+	static void DrawPanel(SoftRender::Frame& frame, const SoftRender::Image& image, int x, int y, int size, const char* title, Axis horizontal, Axis vertical);
+	static void PrintVelocities(const Histograms& histograms);
+
+	Axis Axes::GetGapCenter()
+	{
+		return { 0.0f, static_cast<float>(Externs::screenHeight) };
+	}
+
+	Axis Axes::GetBirdHeight()
+	{
+		return { -100.0f, Externs::screenHeight + 100.0f };
+	}
+
+	int GetBin(float value, Axis axis, int bins)
+	{
+		if (!(value >= axis.min && value < axis.max))
+		{
+			return -1;
+		}
+
+		return std::min(bins - 1, static_cast<int>((value - axis.min) / (axis.max - axis.min) * bins));
+	}
+
+	void Add(Histograms& histograms, const Telemetry::Run& run, int bins)
+	{
+		float gapCenter = (run.gapTop + run.gapBottom) * 0.5f;
+
+		histograms.deaths++;
+		histograms.gapHeight += run.gapBottom - run.gapTop;
+
+		// Rows grow downwards like the screen
+		int column = GetBin(run.deathX - run.obstacleX, Axes::pastObstacle, bins);
+		int row = GetBin(run.deathY - gapCenter, Axes::fromGapCenter, bins);
+
+		if (column >= 0 && row >= 0)
+		{
+			histograms.aroundObstacle[static_cast<size_t>(row) * bins + column]++;
+		}
+		else
+		{
+			histograms.outOfRange++;
+		}
+
+		column = GetBin(gapCenter, Axes::GetGapCenter(), bins);
+		row = GetBin(run.deathY, Axes::GetBirdHeight(), bins);
+
+		if (column >= 0 && row >= 0)
+		{
+			histograms.byGap[static_cast<size_t>(row) * bins + column]++;
+		}
+
+		int velocityBin = GetBin(run.deathVelocity, Axes::velocity, Axes::velocityBins);
+
+		if (velocityBin >= 0)
+		{
+			histograms.velocity[velocityBin]++;
+		}
+	}
+
+	void Merge(Histograms& total, const Histograms& worker)
+	{
+		for (size_t i = 0; i < total.aroundObstacle.size(); i++)
+		{
+			total.aroundObstacle[i] += worker.aroundObstacle[i];
+			total.byGap[i] += worker.byGap[i];
+		}
+
+		for (size_t i = 0; i < total.velocity.size(); i++)
+		{
+			total.velocity[i] += worker.velocity[i];
+		}
+
+		total.deaths += worker.deaths;
+		total.outOfRange += worker.outOfRange;
+		total.gapHeight += worker.gapHeight;
+	}
+
+	uint32_t GetHeatColor(float heat)
+	{
+		// Black, blue, red, yellow, white
+		static const float stops[5][3] = { { 0, 0, 0 }, { 30, 40, 200 }, { 220, 30, 40 }, { 250, 220, 40 }, { 255, 255, 255 } };
+
+		float position = std::max(0.0f, std::min(heat, 1.0f)) * 4.0f;
+		int stop = std::min(3, static_cast<int>(position));
+		float t = position - stop;
+
+		uint32_t color = 0xFF000000u;
+
+		for (int channel = 0; channel < 3; channel++)
+		{
+			float value = stops[stop][channel] + (stops[stop + 1][channel] - stops[stop][channel]) * t;
+			color |= static_cast<uint32_t>(value + 0.5f) << (8 * channel);
+		}
+
+		return color;
+	}
+
+	SoftRender::Image Draw(const std::vector<unsigned long long>& counts, int bins)
+	{
+		SoftRender::Image image;
+		image.width = bins;
+		image.height = bins;
+		image.pixels.resize(counts.size());
+
+		unsigned long long highest = std::max(1ull, *std::max_element(counts.begin(), counts.end()));
+
+		// Log scale, a few cells get most deaths and would leave the rest black
+		for (size_t i = 0; i < counts.size(); i++)
+		{
+			image.pixels[i] = GetHeatColor(static_cast<float>(std::log1p(static_cast<double>(counts[i])) / std::log1p(static_cast<double>(highest))));
+		}
+
+		return image;
+	}
+
+	void DrawPanel(SoftRender::Frame& frame, const SoftRender::Image& image, int x, int y, int size, const char* title, Axis horizontal, Axis vertical)
+	{
+		SoftRender::DrawImage(frame, image, static_cast<float>(x), static_cast<float>(y), static_cast<float>(size), static_cast<float>(size), WHITE);
+		SoftRender::DrawString(frame, title, x, y - 20, 10, LIGHTGRAY);
+
+		std::ostringstream labels;
+		labels << std::fixed << std::setprecision(0) << "x " << horizontal.min << ".." << horizontal.max << "  y " << vertical.min << ".." << vertical.max;
+		SoftRender::DrawString(frame, labels.str(), x, y + size + 8, 10, GRAY);
+	}
+
+	void PrintVelocities(const Histograms& histograms)
+	{
+		unsigned long long highest = std::max(1ull, *std::max_element(histograms.velocity.begin(), histograms.velocity.end()));
+		float binWidth = (Axes::velocity.max - Axes::velocity.min) / Axes::velocityBins;
+
+		std::cout << "velocity at death (up is positive):\n";
+
+		for (int i = 0; i < Axes::velocityBins; i++)
+		{
+			std::cout << std::setw(7) << Axes::velocity.min + i * binWidth << " " << std::string(static_cast<size_t>(50 * histograms.velocity[i] / highest), '#') << " " << histograms.velocity[i] << "\n";
+		}
+	}
+
+	int Run(const Config& config)
+	{
+		if (config.bins < 2 || config.scale < 1 || config.blockSize < 1)
+		{
+			std::cerr << "bins must be at least 2, scale and block size at least 1\n";
+			return 1;
+		}
+
+		Telemetry::Reader reader;
+
+		if (!Telemetry::Open(reader, config.logPath))
+		{
+			std::cerr << "could not read telemetry log " << config.logPath << "\n";
+			return 1;
+		}
+
+		Jobs::Initialize(config.threadCount, config.pinThreads);
+
+		const size_t cellCount = static_cast<size_t>(config.bins) * config.bins;
+
+		std::vector<Histograms> workers(Jobs::GetThreadCount());
+
+		for (Histograms& histograms : workers)
+		{
+			histograms.aroundObstacle.assign(cellCount, 0);
+			histograms.byGap.assign(cellCount, 0);
+			histograms.velocity.assign(Axes::velocityBins, 0);
+		}
+
+		// Two blocks: workers bin one while a reader thread fills the other, so memory stays flat whatever the log size
+		std::vector<Telemetry::Run> blocks[2] = { std::vector<Telemetry::Run>(config.blockSize), std::vector<Telemetry::Run>(config.blockSize) };
+		size_t counts[2] = { 0, 0 };
+
+		unsigned long long runCount = 0;
+		int current = 0;
+
+		auto start = std::chrono::steady_clock::now();
+
+		counts[current] = Telemetry::Read(reader, blocks[current].data(), blocks[current].size());
+
+		while (counts[current] > 0)
+		{
+			int next = 1 - current;
+
+			std::thread prefetch([&]()
+			{
+				counts[next] = Telemetry::Read(reader, blocks[next].data(), blocks[next].size());
+			});
+
+			const std::vector<Telemetry::Run>& runs = blocks[current];
+
+			Jobs::ParallelFor(static_cast<int>(counts[current]), 4096, [&](int begin, int end, int worker)
+			{
+				Histograms& histograms = workers[worker];
+
+				for (int i = begin; i < end; i++)
+				{
+					const Telemetry::Run& run = runs[i];
+
+					bool isWanted = (run.cause == Telemetry::DeathCause::Obstacle && config.hasObstacleDeaths)
+						|| (run.cause == Telemetry::DeathCause::Fall && config.hasFallDeaths);
+
+					if (isWanted && (config.hasPractice || !(run.flags & Telemetry::Flags::practice)))
+					{
+						Add(histograms, run, config.bins);
+					}
+				}
+			});
+
+			prefetch.join();
+
+			runCount += counts[current];
+			current = next;
+		}
+
+		Histograms total = workers[0];
+
+		for (size_t i = 1; i < workers.size(); i++)
+		{
+			Merge(total, workers[i]);
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << runCount << " runs, " << total.deaths << " deaths binned in " << seconds << " s on " << Jobs::GetThreadCount() << " threads ("
+			<< runCount / std::max(seconds, 1e-9) / 1e6 << "M runs/s), " << total.outOfRange << " outside the obstacle map\n";
+
+		if (total.deaths == 0)
+		{
+			Jobs::Shutdown();
+			std::cerr << "no deaths to draw\n";
+			return 1;
+		}
+
+		PrintVelocities(total);
+
+		const int size = config.bins * config.scale;
+		const int margin = 40;
+
+		SoftRender::Image aroundObstacle = Draw(total.aroundObstacle, config.bins);
+		SoftRender::Image byGap = Draw(total.byGap, config.bins);
+
+		SoftRender::Frame frame;
+		SoftRender::Begin(frame, size * 2 + margin * 3, size + margin * 2, { 24, 24, 24, 255 });
+
+		DrawPanel(frame, aroundObstacle, margin, margin, size, "past obstacle edge / from gap center", Axes::pastObstacle, Axes::fromGapCenter);
+		DrawPanel(frame, byGap, size + margin * 2, margin, size, "gap center / bird height", Axes::GetGapCenter(), Axes::GetBirdHeight());
+
+		// Where the obstacle and the gap edges are on the first map
+		float pixelsPerX = size / (Axes::pastObstacle.max - Axes::pastObstacle.min);
+		float pixelsPerY = size / (Axes::fromGapCenter.max - Axes::fromGapCenter.min);
+		float gapHalf = static_cast<float>(total.gapHeight / total.deaths) * 0.5f;
+
+		int edgeX = margin + static_cast<int>(-Axes::pastObstacle.min * pixelsPerX);
+		int gapTop = margin + static_cast<int>((-gapHalf - Axes::fromGapCenter.min) * pixelsPerY);
+		int gapBottom = margin + static_cast<int>((gapHalf - Axes::fromGapCenter.min) * pixelsPerY);
+
+		Color guide = { 255, 255, 255, 90 };
+		SoftRender::FillRectangle(frame, edgeX, margin, 1, size, guide);
+		SoftRender::FillRectangle(frame, margin, gapTop, size, 1, guide);
+		SoftRender::FillRectangle(frame, margin, gapBottom, size, 1, guide);
+
+		SoftRender::Framebuffer framebuffer;
+		SoftRender::Render(frame, framebuffer);
+
+		Jobs::Shutdown();
+
+		if (!SoftRender::SavePpm(framebuffer, config.outputPath))
+		{
+			std::cerr << "could not write " << config.outputPath << "\n";
+			return 1;
+		}
+
+		std::cout << "heatmap written to " << config.outputPath << "\n";
+		return 0;
+	}
+}
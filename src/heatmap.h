@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+
+namespace Heatmap
+{
+	struct Config
+	{
+		std::string logPath;
+		std::string outputPath = "heatmap.ppm";
+
+		// Cells per side of each heatmap, and screen pixels per cell in the image
+		int bins = 256;
+		int scale = 2;
+
+		// Runs read from the log at a time; the next block is read while this one is binned
+		int blockSize = 1 << 16;
+
+		int threadCount = 0;
+		bool pinThreads = false;
+
+		bool hasObstacleDeaths = true;
+		bool hasFallDeaths = true;
+		bool hasPractice = true;
+	};
+
+	// Bins every death of a telemetry log in one streaming pass and draws two heatmaps: where birds die around the
+	// obstacle (distance past its edge against height from the gap center) and bird height against gap height
+	int Run(const Config& config);
+}
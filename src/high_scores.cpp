@@ -0,0 +1,311 @@
+#include "high_scores.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace HighScores
+{
+	struct Header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t slotSize;
+	};
+
+	struct Slot
+	{
+		// The valid slot with the higher sequence is the current one
+		uint64_t sequence;
+		uint64_t checksum;
+
+		Table tables[modeCount];
+	};
+
+	struct File
+	{
+		Header header;
+		Slot slots[2];
+	};
+
+	static_assert(sizeof(Entry) == 32 && sizeof(Table) == 8 + 32 * capacity && sizeof(Slot) == 16 + sizeof(Table) * modeCount, "High score layout must not have padding");
+
+	namespace Variables
+	{
+		const char fileMagic[8] = { 'F', 'L', 'A', 'P', 'B', 'E', 'S', 'T' };
+		const uint32_t fileVersion = 1;
+
+		static File* file = nullptr;
+
+#if defined(_WIN32)
+		static HANDLE handle = INVALID_HANDLE_VALUE;
+		static HANDLE mapping = nullptr;
+#else
+		static int descriptor = -1;
+#endif
+
+		static Table tables[modeCount];
+		static uint64_t sequence = 0;
+		static int currentSlot = 0;
+	}
+
+	static bool IsOurs(const std::string& path);
+	static bool Map(const std::string& path);
+	static void Flush(const void* address, size_t size);
+	static uint64_t GetChecksum(const Slot& slot);
+	static void Write(int slot);
+
+	bool IsOurs(const std::string& path)
+	{
+		std::ifstream existing(path, std::ios::binary);
+		char magic[sizeof(Variables::fileMagic)] = {};
+
+		// Missing or empty is fine, it gets created
+		if (!existing || !existing.read(magic, sizeof(magic)))
+		{
+			return existing.gcount() == 0;
+		}
+
+		return std::memcmp(magic, Variables::fileMagic, sizeof(magic)) == 0;
+	}
+
+	bool Map(const std::string& path)
+	{
+#if defined(_WIN32)
+		Variables::handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (Variables::handle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		// Mapping a size grows the file to it, new bytes read as zero
+		Variables::mapping = CreateFileMappingA(Variables::handle, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(sizeof(File)), nullptr);
+
+		if (Variables::mapping == nullptr)
+		{
+			return false;
+		}
+
+		Variables::file = static_cast<File*>(MapViewOfFile(Variables::mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(File)));
+		return Variables::file != nullptr;
+#else
+		Variables::descriptor = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+
+		struct stat status;
+
+		if (Variables::descriptor < 0 || fstat(Variables::descriptor, &status) != 0)
+		{
+			return false;
+		}
+
+		if (static_cast<size_t>(status.st_size) < sizeof(File) && ftruncate(Variables::descriptor, sizeof(File)) != 0)
+		{
+			return false;
+		}
+
+		void* address = mmap(nullptr, sizeof(File), PROT_READ | PROT_WRITE, MAP_SHARED, Variables::descriptor, 0);
+
+		if (address == MAP_FAILED)
+		{
+			return false;
+		}
+
+		Variables::file = static_cast<File*>(address);
+		return true;
+#endif
+	}
+
+	void Flush(const void* address, size_t size)
+	{
+#if defined(_WIN32)
+		FlushViewOfFile(address, size);
+		FlushFileBuffers(Variables::handle);
+#else
+		// msync wants a page aligned start
+		uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+		uintptr_t start = reinterpret_cast<uintptr_t>(address) & ~(pageSize - 1);
+
+		msync(reinterpret_cast<void*>(start), reinterpret_cast<uintptr_t>(address) + size - start, MS_SYNC);
+#endif
+	}
+
+	uint64_t GetChecksum(const Slot& slot)
+	{
+		// FNV-1a over the sequence and the tables
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&slot.tables);
+		uint64_t hash = 0xCBF29CE484222325ull ^ slot.sequence;
+
+		for (size_t i = 0; i < sizeof(slot.tables); i++)
+		{
+			hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	void Write(int slot)
+	{
+		Slot& target = Variables::file->slots[slot];
+
+		// The checksum only matches once every byte before it landed, a torn write leaves this slot invalid
+		std::memcpy(target.tables, Variables::tables, sizeof(target.tables));
+		target.sequence = Variables::sequence;
+		target.checksum = GetChecksum(target);
+
+		Flush(&target, sizeof(target));
+	}
+
+	bool Open(const std::string& path)
+	{
+		Close();
+
+		// Mapping grows the file, so anything that is not ours is checked before it gets touched
+		if (!IsOurs(path) || !Map(path))
+		{
+			Close();
+			return false;
+		}
+
+		Header& header = Variables::file->header;
+
+		bool isNew = std::all_of(header.magic, header.magic + sizeof(header.magic), [](char c) { return c == 0; });
+
+		if (!isNew && (header.version != Variables::fileVersion || header.slotSize != sizeof(Slot)))
+		{
+			// Another version of ours; leave it alone
+			Close();
+			return false;
+		}
+
+		std::memset(Variables::tables, 0, sizeof(Variables::tables));
+		Variables::sequence = 0;
+		Variables::currentSlot = -1;
+
+		for (int slot = 0; slot < 2 && !isNew; slot++)
+		{
+			const Slot& candidate = Variables::file->slots[slot];
+
+			if (candidate.checksum == GetChecksum(candidate) && (Variables::currentSlot < 0 || candidate.sequence > Variables::sequence))
+			{
+				Variables::currentSlot = slot;
+				Variables::sequence = candidate.sequence;
+			}
+		}
+
+		if (Variables::currentSlot >= 0)
+		{
+			std::memcpy(Variables::tables, Variables::file->slots[Variables::currentSlot].tables, sizeof(Variables::tables));
+
+			for (Table& table : Variables::tables)
+			{
+				table.count = std::min<uint32_t>(table.count, capacity);
+			}
+
+			return true;
+		}
+
+		// New file, or neither copy survived: start both over empty
+		std::memcpy(header.magic, Variables::fileMagic, sizeof(header.magic));
+		header.version = Variables::fileVersion;
+		header.slotSize = sizeof(Slot);
+		Flush(&header, sizeof(header));
+
+		Write(0);
+		Write(1);
+		Variables::currentSlot = 0;
+
+		return true;
+	}
+
+	void Close()
+	{
+#if defined(_WIN32)
+		if (Variables::file != nullptr)
+		{
+			UnmapViewOfFile(Variables::file);
+		}
+
+		if (Variables::mapping != nullptr)
+		{
+			CloseHandle(Variables::mapping);
+		}
+
+		if (Variables::handle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(Variables::handle);
+		}
+
+		Variables::mapping = nullptr;
+		Variables::handle = INVALID_HANDLE_VALUE;
+#else
+		if (Variables::file != nullptr)
+		{
+			munmap(Variables::file, sizeof(File));
+		}
+
+		if (Variables::descriptor >= 0)
+		{
+			close(Variables::descriptor);
+		}
+
+		Variables::descriptor = -1;
+#endif
+
+		Variables::file = nullptr;
+	}
+
+	const Table& GetTable(int mode)
+	{
+		return Variables::tables[mode];
+	}
+
+	int Insert(int mode, const Entry& entry)
+	{
+		Table& table = Variables::tables[mode];
+		Entry* end = table.entries + table.count;
+
+		// Binary search for the first entry scoring less, so equal scores stay in the order they were set
+		Entry* position = std::upper_bound(table.entries, end, entry, [](const Entry& a, const Entry& b)
+		{
+			return a.score > b.score;
+		});
+
+		int rank = static_cast<int>(position - table.entries);
+
+		if (rank >= capacity)
+		{
+			return -1;
+		}
+
+		if (table.count < static_cast<uint32_t>(capacity))
+		{
+			table.count++;
+			end++;
+		}
+
+		std::copy_backward(position, end - 1, end);
+		*position = entry;
+
+		// Without a file the table still works for this session
+		if (Variables::file != nullptr)
+		{
+			Variables::sequence++;
+			Variables::currentSlot = 1 - Variables::currentSlot;
+			Write(Variables::currentSlot);
+		}
+
+		return rank;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Best scores per mode in a memory-mapped file. The file holds two copies of the tables; an update writes the older copy
+// and stamps it with a newer sequence and a checksum, so a crash mid-write leaves the previous tables readable.
+// Kept free of raylib so the platform headers can be included
+namespace HighScores
+{
+	// Indexed like World::Playstyle
+	const int modeCount = 2;
+	const int capacity = 64;
+
+	// Ranks the menu lists; a round is only announced as a new high score when it makes one of these
+	const int shownCount = 5;
+
+	// Fixed width fields only, laid out without padding; the file is this memory as is
+	struct Entry
+	{
+		int32_t score;
+		float timeAlive;
+		uint64_t seed;
+
+		// Seconds since the epoch
+		uint64_t time;
+
+		uint32_t playerCount;
+		uint32_t reserved;
+	};
+
+	// Best first; equal scores keep the one set earlier ahead
+	struct Table
+	{
+		uint32_t count;
+		uint32_t reserved;
+
+		Entry entries[capacity];
+	};
+
+	bool Open(const std::string& path);
+	void Close();
+
+	// The copy in memory, reading it never touches the file
+	const Table& GetTable(int mode);
+
+	// Returns the rank the entry got, or -1 when it did not make the table
+	int Insert(int mode, const Entry& entry);
+}
@@ -0,0 +1,335 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Jobs
+{
+	const size_t cacheLineSize = 64;
+
+	// Padding up to the alignment is the point here
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable: 4324)
+#endif
+
+	// The owner pops from begin, thieves split off the back, so this acts as the worker's deque of indices. Each starts on
+	// its own cache line, so neighbouring workers' ranges never share one
+	struct alignas(cacheLineSize) Worker
+	{
+		std::mutex mutex;
+
+		int begin = 0;
+		int end = 0;
+	};
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+	namespace Variables
+	{
+		// new only honors alignment past the default from C++17 on, so the array is placed in memory aligned by hand
+		static std::unique_ptr<char[]> workerMemory;
+		static Worker* workers = nullptr;
+		static std::vector<std::thread> threads;
+		static int threadCount = 1;
+		static bool isPinned = false;
+
+		static std::mutex jobMutex;
+
+		static std::mutex stateMutex;
+		static std::condition_variable wake;
+		static std::condition_variable done;
+		static unsigned long long generation = 0;
+		static int activeWorkers = 0;
+		static bool isShuttingDown = false;
+
+		static const RangeJob* job = nullptr;
+		static int chunkSize = 1;
+	}
+
+	static void CreateWorkers(int count);
+	static void DestroyWorkers();
+	static void PinCurrentThread(int index);
+	static void WorkerMain(int index);
+	static void RunWorker(int index);
+	static bool PopChunk(int index, int& begin, int& end);
+	static bool Steal(int index);
+
+	void CreateWorkers(int count)
+	{
+		size_t size = sizeof(Worker) * static_cast<size_t>(count) + cacheLineSize;
+		Variables::workerMemory.reset(new char[size]);
+
+		void* memory = Variables::workerMemory.get();
+		std::align(cacheLineSize, sizeof(Worker) * static_cast<size_t>(count), memory, size);
+
+		Variables::workers = static_cast<Worker*>(memory);
+
+		for (int i = 0; i < count; i++)
+		{
+			new (&Variables::workers[i]) Worker();
+		}
+	}
+
+	void DestroyWorkers()
+	{
+		for (int i = 0; Variables::workers != nullptr && i < Variables::threadCount; i++)
+		{
+			Variables::workers[i].~Worker();
+		}
+
+		Variables::workers = nullptr;
+		Variables::workerMemory.reset();
+	}
+
+	void PinCurrentThread(int index)
+	{
+		unsigned int cpuCount = std::max(std::thread::hardware_concurrency(), 1u);
+		unsigned int cpu = static_cast<unsigned int>(index) % cpuCount;
+
+#if defined(_WIN32)
+		if (cpu < 64)
+		{
+			SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+		}
+#elif defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+		(void)cpu;
+#endif
+	}
+
+	void WorkerMain(int index)
+	{
+		if (Variables::isPinned)
+		{
+			PinCurrentThread(index);
+		}
+
+		unsigned long long seenGeneration = 0;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(Variables::stateMutex);
+				Variables::wake.wait(lock, [&]()
+				{
+					return Variables::isShuttingDown || Variables::generation != seenGeneration;
+				});
+
+				if (Variables::isShuttingDown)
+				{
+					return;
+				}
+
+				seenGeneration = Variables::generation;
+			}
+
+			RunWorker(index);
+
+			std::lock_guard<std::mutex> lock(Variables::stateMutex);
+
+			if (--Variables::activeWorkers == 0)
+			{
+				Variables::done.notify_one();
+			}
+		}
+	}
+
+	void RunWorker(int index)
+	{
+		int begin = 0;
+		int end = 0;
+
+		while (true)
+		{
+			if (PopChunk(index, begin, end))
+			{
+				(*Variables::job)(begin, end, index);
+			}
+			else if (!Steal(index))
+			{
+				// Ranges only ever shrink or move between workers, so an empty sweep means nothing is left to start
+				return;
+			}
+		}
+	}
+
+	bool PopChunk(int index, int& begin, int& end)
+	{
+		Worker& worker = Variables::workers[index];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+
+		if (worker.begin >= worker.end)
+		{
+			return false;
+		}
+
+		begin = worker.begin;
+		end = std::min(worker.begin + Variables::chunkSize, worker.end);
+		worker.begin = end;
+
+		return true;
+	}
+
+	// Takes work from the first other worker that has any: the back half of its range, or all of it when no more than a
+	// chunk is left. The victim keeps popping from the front of what stays
+	bool Steal(int index)
+	{
+		for (int offset = 1; offset < Variables::threadCount; offset++)
+		{
+			Worker& victim = Variables::workers[(index + offset) % Variables::threadCount];
+
+			int stolenBegin = 0;
+			int stolenEnd = 0;
+
+			{
+				std::lock_guard<std::mutex> lock(victim.mutex);
+
+				int remaining = victim.end - victim.begin;
+
+				if (remaining <= 0)
+				{
+					continue;
+				}
+
+				// The victim keeps at least a chunk unless that is all it has
+				int kept = remaining > Variables::chunkSize ? std::max(remaining / 2, Variables::chunkSize) : 0;
+
+				stolenBegin = victim.begin + kept;
+				stolenEnd = victim.end;
+				victim.end = stolenBegin;
+			}
+
+			if (stolenBegin < stolenEnd)
+			{
+				Worker& thief = Variables::workers[index];
+				std::lock_guard<std::mutex> lock(thief.mutex);
+
+				thief.begin = stolenBegin;
+				thief.end = stolenEnd;
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void Initialize(int threadCount, bool pinThreads)
+	{
+		Shutdown();
+
+		if (threadCount <= 0)
+		{
+			threadCount = static_cast<int>(std::thread::hardware_concurrency());
+		}
+
+		Variables::threadCount = std::max(threadCount, 1);
+		Variables::isPinned = pinThreads;
+		CreateWorkers(Variables::threadCount);
+		Variables::isShuttingDown = false;
+		Variables::generation = 0;
+
+		if (pinThreads)
+		{
+			PinCurrentThread(0);
+		}
+
+		for (int i = 1; i < Variables::threadCount; i++)
+		{
+			Variables::threads.emplace_back(WorkerMain, i);
+		}
+	}
+
+	void Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Variables::stateMutex);
+			Variables::isShuttingDown = true;
+		}
+
+		Variables::wake.notify_all();
+
+		for (std::thread& thread : Variables::threads)
+		{
+			thread.join();
+		}
+
+		Variables::threads.clear();
+		DestroyWorkers();
+		Variables::threadCount = 1;
+	}
+
+	int GetThreadCount()
+	{
+		return Variables::threadCount;
+	}
+
+	void ParallelFor(int count, int chunkSize, const RangeJob& job)
+	{
+		if (count <= 0)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> jobLock(Variables::jobMutex);
+
+		if (!Variables::workers)
+		{
+			Initialize(1, false);
+		}
+
+		Variables::job = &job;
+		Variables::chunkSize = std::max(chunkSize, 1);
+
+		const int workerCount = Variables::threadCount;
+
+		for (int i = 0; i < workerCount; i++)
+		{
+			Worker& worker = Variables::workers[i];
+			std::lock_guard<std::mutex> lock(worker.mutex);
+
+			worker.begin = static_cast<int>(static_cast<long long>(count) * i / workerCount);
+			worker.end = static_cast<int>(static_cast<long long>(count) * (i + 1) / workerCount);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(Variables::stateMutex);
+			Variables::activeWorkers = workerCount - 1;
+			Variables::generation++;
+		}
+
+		Variables::wake.notify_all();
+
+		RunWorker(0);
+
+		std::unique_lock<std::mutex> lock(Variables::stateMutex);
+		Variables::done.wait(lock, []()
+		{
+			return Variables::activeWorkers == 0;
+		});
+
+		Variables::job = nullptr;
+	}
+}
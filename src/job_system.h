@@ -0,0 +1,18 @@
+#pragma once
+#include <functional>
+
+namespace Jobs
+{
+	// Called with a half-open index range and the index of the worker running it
+	typedef std::function<void(int begin, int end, int worker)> RangeJob;
+
+	// threadCount 0 uses every hardware thread; the calling thread counts as worker 0
+	void Initialize(int threadCount, bool pinThreads);
+	void Shutdown();
+
+	int GetThreadCount();
+
+	// Splits [0, count) across the workers, each owning a range it pops chunkSize items at a time from the front.
+	// Idle workers steal the back half of another worker's range. Blocks until every item ran; not reentrant from inside a job
+	void ParallelFor(int count, int chunkSize, const RangeJob& job);
+}
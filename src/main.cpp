@@ -1,7 +1,149 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
 #include "game_loop.h"
+#include "globals.h"
+
+static void PrintUsage();
+
+// Reads <local port> <remote port> <player 1|2> followed by any of its options; returns how many arguments were used, or 0 if they are wrong
+static int ParseNetplay(int argc, char* argv[], Netplay::Config& config);
 
-int main()
+int ParseNetplay(int argc, char* argv[], Netplay::Config& config)
 {
+	if (argc < 3)
+	{
+		return 0;
+	}
+
+	config.localPort = static_cast<uint16_t>(std::atoi(argv[0]));
+	config.remotePort = static_cast<uint16_t>(std::atoi(argv[1]));
+	config.localPlayer = std::atoi(argv[2]) == 2 ? 1 : 0;
+
+	int used = 3;
+
+	while (used + 1 < argc)
+	{
+		std::string option = argv[used];
+		const char* value = argv[used + 1];
+
+		if (option == "--host")
+		{
+			config.remoteHost = value;
+		}
+		else if (option == "--delay")
+		{
+			config.inputDelay = std::atoi(value);
+		}
+		else if (option == "--latency")
+		{
+			config.latencyMs = std::atoi(value);
+		}
+		else if (option == "--jitter")
+		{
+			config.jitterMs = std::atoi(value);
+		}
+		else if (option == "--loss")
+		{
+			config.lossChance = static_cast<float>(std::atof(value));
+		}
+		else
+		{
+			break;
+		}
+
+		used += 2;
+	}
+
+	return used;
+}
+
+void PrintUsage()
+{
+	std::cerr << "usage: FlappyBird [--hash-log PATH] [--replay PATH] [--telemetry PATH | --no-telemetry] [--tuning PATH] [--agent NAME]\n"
+		"                  [--bindings PATH] [--seed HEX | --daily]\n"
+		"                  [--netplay <local port> <remote port> <player 1|2> [--host IP] [--delay N] [--latency MS] [--jitter MS] [--loss F]]\n";
+}
+
+int main(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+
+		if (option == "--hash-log" && i + 1 < argc)
+		{
+			Externs::hashLogPath = argv[++i];
+		}
+		else if (option == "--replay" && i + 1 < argc)
+		{
+			Externs::replayPath = argv[++i];
+		}
+		else if (option == "--telemetry" && i + 1 < argc)
+		{
+			Externs::telemetryPath = argv[++i];
+		}
+		else if (option == "--tuning" && i + 1 < argc)
+		{
+			Externs::tuningPath = argv[++i];
+		}
+		else if (option == "--bindings" && i + 1 < argc)
+		{
+			Externs::bindingsPath = argv[++i];
+		}
+		else if (option == "--seed" && i + 1 < argc)
+		{
+			// Hex, as the results screen shows it
+			char* end = nullptr;
+			Externs::seed = std::strtoull(argv[++i], &end, 16);
+
+			if (end == argv[i] || *end != '\0')
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+		else if (option == "--daily")
+		{
+			Externs::isDailyChallenge = true;
+		}
+		else if (option == "--agent" && i + 1 < argc)
+		{
+			Externs::agentName = argv[++i];
+		}
+		else if (option == "--no-telemetry")
+		{
+			Externs::telemetryPath.clear();
+		}
+		else if (option == "--netplay")
+		{
+			Netplay::Config config;
+			int used = ParseNetplay(argc - i - 1, argv + i + 1, config);
+
+			if (used == 0)
+			{
+				PrintUsage();
+				return 1;
+			}
+
+			Game::EnableNetplay(config);
+			i += used;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	// Both pin the seed, and a daily run has to play the day's seed
+	if (Externs::seed != 0 && Externs::isDailyChallenge)
+	{
+		PrintUsage();
+		return 1;
+	}
+
 	Game::GameLoop();
 
 	return 0;
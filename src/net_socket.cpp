@@ -0,0 +1,150 @@
+#include "net_socket.h"
+
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace NetSocket
+{
+#if defined(_WIN32)
+	typedef SOCKET NativeSocket;
+	const NativeSocket invalidSocket = INVALID_SOCKET;
+
+	namespace Variables
+	{
+		static int openSockets = 0;
+	}
+#else
+	typedef int NativeSocket;
+	const NativeSocket invalidSocket = -1;
+#endif
+
+	static NativeSocket ToNative(const Socket& socket);
+
+	NativeSocket ToNative(const Socket& socket)
+	{
+		return static_cast<NativeSocket>(socket.handle);
+	}
+
+	bool Open(Socket& socket, uint16_t port)
+	{
+		socket.handle = 0;
+		socket.isOpen = false;
+
+#if defined(_WIN32)
+		if (Variables::openSockets == 0)
+		{
+			WSADATA data;
+
+			if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+			{
+				return false;
+			}
+		}
+
+		Variables::openSockets++;
+#endif
+
+		NativeSocket native = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+		if (native == invalidSocket)
+		{
+			Close(socket);
+			return false;
+		}
+
+		socket.handle = static_cast<intptr_t>(native);
+		socket.isOpen = true;
+
+		sockaddr_in local;
+		std::memset(&local, 0, sizeof(local));
+		local.sin_family = AF_INET;
+		local.sin_addr.s_addr = htonl(INADDR_ANY);
+		local.sin_port = htons(port);
+
+		if (bind(native, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0)
+		{
+			Close(socket);
+			return false;
+		}
+
+#if defined(_WIN32)
+		u_long isNonBlocking = 1;
+		bool isConfigured = ioctlsocket(native, FIONBIO, &isNonBlocking) == 0;
+#else
+		bool isConfigured = fcntl(native, F_SETFL, fcntl(native, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+
+		if (!isConfigured)
+		{
+			Close(socket);
+			return false;
+		}
+
+		return true;
+	}
+
+	void Close(Socket& socket)
+	{
+		if (socket.isOpen)
+		{
+#if defined(_WIN32)
+			closesocket(ToNative(socket));
+#else
+			close(ToNative(socket));
+#endif
+		}
+
+#if defined(_WIN32)
+		if (Variables::openSockets > 0 && --Variables::openSockets == 0)
+		{
+			WSACleanup();
+		}
+#endif
+
+		socket.isOpen = false;
+	}
+
+	bool ParseAddress(const char* text, uint32_t& address)
+	{
+		in_addr parsed;
+
+		if (inet_pton(AF_INET, text, &parsed) != 1)
+		{
+			return false;
+		}
+
+		address = ntohl(parsed.s_addr);
+		return true;
+	}
+
+	bool Send(Socket& socket, uint32_t address, uint16_t port, const void* data, int size)
+	{
+		sockaddr_in remote;
+		std::memset(&remote, 0, sizeof(remote));
+		remote.sin_family = AF_INET;
+		remote.sin_addr.s_addr = htonl(address);
+		remote.sin_port = htons(port);
+
+		return sendto(ToNative(socket), static_cast<const char*>(data), size, 0, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) == size;
+	}
+
+	int Receive(Socket& socket, void* buffer, int size)
+	{
+		int received = static_cast<int>(recvfrom(ToNative(socket), static_cast<char*>(buffer), size, 0, nullptr, nullptr));
+
+		return received > 0 ? received : 0;
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+
+namespace NetSocket
+{
+	// Non-blocking IPv4 UDP socket; kept apart from raylib.h because the platform socket headers clash with it
+	struct Socket
+	{
+		intptr_t handle;
+		bool isOpen;
+	};
+
+	bool Open(Socket& socket, uint16_t port);
+	void Close(Socket& socket);
+
+	bool ParseAddress(const char* text, uint32_t& address);
+
+	bool Send(Socket& socket, uint32_t address, uint16_t port, const void* data, int size);
+
+	// Returns the number of bytes read, or 0 when nothing is waiting
+	int Receive(Socket& socket, void* buffer, int size);
+}
@@ -0,0 +1,415 @@
+#include "netplay.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Netplay
+{
+	namespace Variables
+	{
+		const uint32_t packetMagic = 0x46425250; // "FBRP"
+		const int headerSize = 4 + 1 + 1 + 8 + 4 + 4;
+		const double helloInterval = 0.1;
+	}
+
+	static double Now();
+	static int Slot(long long tick);
+
+	static void WriteU32(uint8_t* bytes, uint32_t value);
+	static void WriteU64(uint8_t* bytes, uint64_t value);
+	static uint32_t ReadU32(const uint8_t* bytes);
+	static uint64_t ReadU64(const uint8_t* bytes);
+
+	static void Connect(Session& session, World::World& world, uint64_t seed);
+	static void QueuePacket(Session& session, const uint8_t* bytes, int size);
+	static void SendInputs(Session& session);
+	static void FlushPending(Session& session);
+	static void ReceivePackets(Session& session, World::World& world);
+	static void HandlePacket(Session& session, World::World& world, const uint8_t* bytes, int size);
+
+	static void Simulate(Session& session, World::World& world, long long tick);
+	static void Resimulate(Session& session, World::World& world);
+
+	double Now()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	int Slot(long long tick)
+	{
+		return static_cast<int>(tick % historySize);
+	}
+
+	void WriteU32(uint8_t* bytes, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+		}
+	}
+
+	void WriteU64(uint8_t* bytes, uint64_t value)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+		}
+	}
+
+	uint32_t ReadU32(const uint8_t* bytes)
+	{
+		uint32_t value = 0;
+
+		for (int i = 0; i < 4; i++)
+		{
+			value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+		}
+
+		return value;
+	}
+
+	uint64_t ReadU64(const uint8_t* bytes)
+	{
+		uint64_t value = 0;
+
+		for (int i = 0; i < 8; i++)
+		{
+			value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+		}
+
+		return value;
+	}
+
+	bool Start(Session& session, const Config& config)
+	{
+		Stop(session);
+
+		session.config = config;
+		session.isRunning = false;
+		session.tick = 0;
+		session.remoteContiguous = -1;
+		session.pendingCount = 0;
+		session.lastHelloTime = 0.0;
+		session.stats = Stats();
+		session.seed = config.seed != 0 ? config.seed : Rng::RandomSeed();
+
+		Rng::Seed(session.networkRng, session.seed, static_cast<uint64_t>(config.localPlayer) + 1);
+
+		if (!NetSocket::ParseAddress(config.remoteHost.c_str(), session.remoteAddress))
+		{
+			return false;
+		}
+
+		session.isOpen = NetSocket::Open(session.socket, config.localPort);
+
+		return session.isOpen;
+	}
+
+	void Stop(Session& session)
+	{
+		if (session.isOpen)
+		{
+			NetSocket::Close(session.socket);
+		}
+
+		session.isOpen = false;
+		session.isRunning = false;
+	}
+
+	void Poll(Session& session, World::World& world)
+	{
+		if (!session.isOpen)
+		{
+			return;
+		}
+
+		ReceivePackets(session, world);
+
+		// Right away rather than on the next tick, or a frame without one would leave mispredicted states in the history
+		if (session.isRunning && session.rollbackTo >= 0)
+		{
+			Resimulate(session, world);
+		}
+
+		if (!session.isRunning)
+		{
+			double now = Now();
+
+			// An empty input packet doubles as the hello
+			if (now - session.lastHelloTime > Variables::helloInterval)
+			{
+				SendInputs(session);
+				session.lastHelloTime = now;
+			}
+		}
+
+		FlushPending(session);
+	}
+
+	bool Update(Session& session, World::World& world, bool isLocalMoving)
+	{
+		Poll(session, world);
+
+		if (!session.isRunning)
+		{
+			return false;
+		}
+
+		session.stats.remoteLag = static_cast<int>(session.tick - 1 - session.remoteContiguous);
+
+		bool hasTicked = false;
+
+		if (session.tick - session.remoteContiguous > maxPrediction)
+		{
+			// Too far ahead of what the peer has told us, wait for it instead of predicting further
+			session.stats.stalls++;
+		}
+		else
+		{
+			session.localInputs[Slot(session.tick + session.config.inputDelay)] = isLocalMoving ? 1 : 0;
+
+			Simulate(session, world, session.tick);
+			session.tick++;
+
+			hasTicked = true;
+		}
+
+		SendInputs(session);
+		FlushPending(session);
+
+		return hasTicked;
+	}
+
+	long long GetConfirmedTick(const Session& session)
+	{
+		return std::min(session.tick - 1, session.remoteContiguous);
+	}
+
+	void Connect(Session& session, World::World& world, uint64_t seed)
+	{
+		session.seed = seed;
+		session.isRunning = true;
+
+		session.tick = 0;
+		session.remoteContiguous = -1;
+		session.remoteAck = -1;
+		session.rollbackTo = -1;
+		session.lostTicksNow = 0;
+
+		for (int i = 0; i < historySize; i++)
+		{
+			session.localInputs[i] = 0;
+			session.remoteInputs[i] = 0;
+			session.usedRemoteInputs[i] = 0;
+			session.remoteInputTicks[i] = -1;
+			session.lostTicks[i] = 0;
+		}
+
+		World::Reset(world, playerCount, seed);
+	}
+
+	void QueuePacket(Session& session, const uint8_t* bytes, int size)
+	{
+		const Config& config = session.config;
+
+		if (config.lossChance > 0.0f && Rng::Float(session.networkRng) < config.lossChance)
+		{
+			return;
+		}
+
+		if (session.pendingCount >= maxPendingPackets)
+		{
+			return;
+		}
+
+		PendingPacket& packet = session.pending[session.pendingCount++];
+
+		double delay = config.latencyMs / 1000.0;
+
+		if (config.jitterMs > 0)
+		{
+			delay += Rng::Range(session.networkRng, 0, config.jitterMs) / 1000.0;
+		}
+
+		packet.sendTime = Now() + delay;
+		packet.size = size;
+		std::copy(bytes, bytes + size, packet.bytes);
+	}
+
+	void SendInputs(Session& session)
+	{
+		uint8_t bytes[maxPacketSize];
+
+		// Everything the peer has not acknowledged yet, so lost packets are covered by the next one
+		long long lastTick = session.isRunning ? session.tick + session.config.inputDelay - 1 : -1;
+		long long firstTick = std::max(session.remoteAck + 1, lastTick - maxSentInputs + 1);
+		int count = lastTick >= firstTick ? static_cast<int>(lastTick - firstTick + 1) : 0;
+
+		if (firstTick < 0)
+		{
+			firstTick = 0;
+		}
+
+		WriteU32(bytes, Variables::packetMagic);
+		bytes[4] = static_cast<uint8_t>(session.config.localPlayer);
+		bytes[5] = static_cast<uint8_t>(count);
+		WriteU64(bytes + 6, session.seed);
+		WriteU32(bytes + 14, static_cast<uint32_t>(firstTick));
+		WriteU32(bytes + 18, static_cast<uint32_t>(session.isRunning ? session.remoteContiguous : -1));
+
+		for (int i = 0; i < count; i++)
+		{
+			bytes[Variables::headerSize + i] = session.localInputs[Slot(firstTick + i)];
+		}
+
+		QueuePacket(session, bytes, Variables::headerSize + count);
+	}
+
+	void FlushPending(Session& session)
+	{
+		double now = Now();
+		int kept = 0;
+
+		for (int i = 0; i < session.pendingCount; i++)
+		{
+			PendingPacket& packet = session.pending[i];
+
+			if (packet.sendTime <= now)
+			{
+				NetSocket::Send(session.socket, session.remoteAddress, session.config.remotePort, packet.bytes, packet.size);
+				session.stats.packetsSent++;
+			}
+			else
+			{
+				if (kept != i)
+				{
+					session.pending[kept] = packet;
+				}
+
+				kept++;
+			}
+		}
+
+		session.pendingCount = kept;
+	}
+
+	void ReceivePackets(Session& session, World::World& world)
+	{
+		uint8_t bytes[maxPacketSize];
+		int size = NetSocket::Receive(session.socket, bytes, maxPacketSize);
+
+		while (size > 0)
+		{
+			HandlePacket(session, world, bytes, size);
+			size = NetSocket::Receive(session.socket, bytes, maxPacketSize);
+		}
+	}
+
+	void HandlePacket(Session& session, World::World& world, const uint8_t* bytes, int size)
+	{
+		if (size < Variables::headerSize || ReadU32(bytes) != Variables::packetMagic)
+		{
+			return;
+		}
+
+		int player = bytes[4];
+		int count = bytes[5];
+
+		if (player == session.config.localPlayer || size < Variables::headerSize + count)
+		{
+			return;
+		}
+
+		session.stats.packetsReceived++;
+
+		if (!session.isRunning)
+		{
+			Connect(session, world, session.config.localPlayer == 0 ? session.seed : ReadU64(bytes + 6));
+		}
+
+		long long firstTick = ReadU32(bytes + 14);
+		long long ack = static_cast<int32_t>(ReadU32(bytes + 18));
+
+		session.remoteAck = std::max(session.remoteAck, std::min(ack, session.tick + session.config.inputDelay - 1));
+
+		for (int i = 0; i < count; i++)
+		{
+			long long remoteTick = firstTick + i;
+			int slot = Slot(remoteTick);
+
+			if (remoteTick <= session.remoteContiguous || session.remoteInputTicks[slot] == remoteTick || remoteTick >= session.tick + historySize - maxPrediction)
+			{
+				continue;
+			}
+
+			uint8_t input = bytes[Variables::headerSize + i];
+
+			session.remoteInputs[slot] = input;
+			session.remoteInputTicks[slot] = remoteTick;
+
+			if (remoteTick < session.tick && input != session.usedRemoteInputs[slot])
+			{
+				session.rollbackTo = session.rollbackTo < 0 ? remoteTick : std::min(session.rollbackTo, remoteTick);
+			}
+		}
+
+		while (session.remoteInputTicks[Slot(session.remoteContiguous + 1)] == session.remoteContiguous + 1)
+		{
+			session.remoteContiguous++;
+		}
+	}
+
+	void Simulate(Session& session, World::World& world, long long tick)
+	{
+		int slot = Slot(tick);
+
+		Snapshot::Capture(world, session.states[slot]);
+		session.lostTicks[slot] = session.lostTicksNow;
+
+		// Flaps are one tick events, so the best guess for an unknown remote tick is no flap
+		uint8_t remote = session.remoteInputTicks[slot] == tick ? session.remoteInputs[slot] : 0;
+		uint8_t local = tick < session.config.inputDelay ? 0 : session.localInputs[slot];
+
+		session.usedRemoteInputs[slot] = remote;
+
+		int localPlayer = session.config.localPlayer;
+		World::Input input = static_cast<World::Input>((local << localPlayer) | (remote << (1 - localPlayer)));
+
+		World::Step<playerCount>(world, input);
+
+		if (world.hasLost && ++session.lostTicksNow >= restartTicks)
+		{
+			uint64_t seed = (static_cast<uint64_t>(Rng::Next(world.rng)) << 32) | Rng::Next(world.rng);
+
+			World::Reset(world, playerCount, seed);
+			session.lostTicksNow = 0;
+		}
+	}
+
+	void Resimulate(Session& session, World::World& world)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		long long from = session.rollbackTo;
+		session.rollbackTo = -1;
+
+		Snapshot::Restore(world, session.states[Slot(from)]);
+		session.lostTicksNow = session.lostTicks[Slot(from)];
+
+		for (long long tick = from; tick < session.tick; tick++)
+		{
+			Simulate(session, world, tick);
+		}
+
+		double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		int ticks = static_cast<int>(session.tick - from);
+
+		Stats& stats = session.stats;
+
+		stats.rollbacks++;
+		stats.lastRollbackTicks = ticks;
+		stats.maxRollbackTicks = std::max(stats.maxRollbackTicks, ticks);
+		stats.lastResimulateMs = elapsed;
+		stats.maxResimulateMs = std::max(stats.maxResimulateMs, elapsed);
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "net_socket.h"
+#include "snapshot.h"
+#include "world.h"
+
+namespace Netplay
+{
+	struct Config
+	{
+		uint16_t localPort = 7000;
+		uint16_t remotePort = 7001;
+		std::string remoteHost = "127.0.0.1";
+
+		// Player 0 hosts: its seed is the one both peers play
+		int localPlayer = 0;
+
+		// Ticks local presses are held back, trading a little latency for fewer rollbacks
+		int inputDelay = 2;
+
+		// Artificial conditions applied to outgoing packets, for testing on one machine
+		int latencyMs = 0;
+		int jitterMs = 0;
+		float lossChance = 0.0f;
+
+		uint64_t seed = 0;
+	};
+
+	// One bird per peer
+	const int playerCount = 2;
+
+	const int historySize = 64;
+	const int maxPrediction = 16;
+	const int maxSentInputs = 48;
+	const int maxPendingPackets = 256;
+	const int maxPacketSize = 128;
+
+	// Ticks between both birds being down and the next round starting
+	const int restartTicks = 360;
+
+	struct Stats
+	{
+		unsigned long long rollbacks = 0;
+		int lastRollbackTicks = 0;
+		int maxRollbackTicks = 0;
+
+		double lastResimulateMs = 0.0;
+		double maxResimulateMs = 0.0;
+
+		unsigned long long stalls = 0;
+		unsigned long long packetsSent = 0;
+		unsigned long long packetsReceived = 0;
+
+		int remoteLag = 0;
+	};
+
+	struct PendingPacket
+	{
+		double sendTime;
+		int size;
+		uint8_t bytes[maxPacketSize];
+	};
+
+	struct Session
+	{
+		Config config;
+
+		NetSocket::Socket socket;
+		uint32_t remoteAddress;
+
+		bool isOpen;
+		bool isRunning;
+
+		uint64_t seed;
+
+		// Next tick to simulate
+		long long tick;
+
+		uint8_t localInputs[historySize];
+		uint8_t remoteInputs[historySize];
+		uint8_t usedRemoteInputs[historySize];
+		long long remoteInputTicks[historySize];
+
+		long long remoteContiguous;
+		long long remoteAck;
+		long long rollbackTo;
+
+		// State before each tick, and the round restart countdown that goes with it
+		Snapshot::Snapshot states[historySize];
+		int lostTicks[historySize];
+		int lostTicksNow;
+
+		PendingPacket pending[maxPendingPackets];
+		int pendingCount;
+		double lastHelloTime;
+
+		Rng::Rng networkRng;
+
+		Stats stats;
+	};
+
+	bool Start(Session& session, const Config& config);
+	void Stop(Session& session);
+
+	// Handles incoming packets, runs the rollback they call for and sends what is due, for frames with no tick to run.
+	// Afterwards the states of every confirmed tick are final
+	void Poll(Session& session, World::World& world);
+
+	// Polls the network and, unless too far ahead of the peer, advances the world one tick. Returns whether it ticked
+	bool Update(Session& session, World::World& world, bool isLocalMoving);
+
+	// Highest tick whose inputs from both players are known, so its result can no longer change
+	long long GetConfirmedTick(const Session& session);
+}
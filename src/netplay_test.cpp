@@ -0,0 +1,204 @@
+#include "netplay_test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "globals.h"
+#include "netplay.h"
+#include "snapshot.h"
+#include "world.h"
+
+namespace NetplayTest
+{
+	struct Peer
+	{
+		std::unique_ptr<Netplay::Session> session;
+		World::World world;
+
+		// State before every confirmed tick, in session ticks
+		std::vector<Snapshot::Snapshot> confirmed;
+
+		bool isStarted;
+	};
+
+	static bool IsScriptedFlap(const Player::Bird& bird, Rng::Rng& rng);
+	static void RunPeer(Peer& peer, const Config& config, std::atomic<int>& doneCount);
+	static bool RunFrame(Peer& peer, const Config& config, Rng::Rng& inputRng, double& accumulator);
+	static void RecordConfirmed(Peer& peer);
+
+	bool IsScriptedFlap(const Player::Bird& bird, Rng::Rng& rng)
+	{
+		// Stays up for a while with some noise, so flaps keep arriving at unpredictable ticks
+		bool isFalling = bird.position.y > Externs::screenHeight * 0.55f && bird.velocity < 0.0f;
+
+		return isFalling ? Rng::Float(rng) < 0.5f : Rng::Float(rng) < 0.01f;
+	}
+
+	bool RunFrame(Peer& peer, const Config& config, Rng::Rng& inputRng, double& accumulator)
+	{
+		Netplay::Session& session = *peer.session;
+		const Player::Bird& bird = peer.world.birds[session.config.localPlayer];
+
+		if (config.frameRate <= 0.0f)
+		{
+			return Netplay::Update(session, peer.world, session.isRunning && IsScriptedFlap(bird, inputRng));
+		}
+
+		// What Playing::Network::Tick does
+		const double period = 1.0 / config.tickRate;
+		accumulator = std::min(accumulator + 1.0 / config.frameRate, 0.25);
+
+		Netplay::Poll(session, peer.world);
+
+		while (accumulator >= period && Netplay::Update(session, peer.world, session.isRunning && IsScriptedFlap(bird, inputRng)))
+		{
+			accumulator -= period;
+		}
+
+		return true;
+	}
+
+	void RecordConfirmed(Peer& peer)
+	{
+		long long confirmedTick = Netplay::GetConfirmedTick(*peer.session);
+
+		while (static_cast<long long>(peer.confirmed.size()) <= confirmedTick)
+		{
+			peer.confirmed.push_back(peer.session->states[peer.confirmed.size() % Netplay::historySize]);
+		}
+	}
+
+	void RunPeer(Peer& peer, const Config& config, std::atomic<int>& doneCount)
+	{
+		Netplay::Session& session = *peer.session;
+		int localPlayer = session.config.localPlayer;
+
+		Rng::Rng inputRng;
+		Rng::Seed(inputRng, config.seed, static_cast<uint64_t>(localPlayer) + 100);
+
+		const double period = 1.0 / (config.frameRate > 0.0f ? config.frameRate : config.tickRate);
+		const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30) + std::chrono::duration<double>(config.ticks / config.tickRate * 4.0);
+
+		auto next = std::chrono::steady_clock::now();
+		bool isDone = false;
+		double accumulator = 0.0;
+
+		while (doneCount.load() < 2 && std::chrono::steady_clock::now() < timeout)
+		{
+			std::this_thread::sleep_until(next);
+
+			bool hasTicked = RunFrame(peer, config, inputRng, accumulator);
+			RecordConfirmed(peer);
+
+			if (!isDone && Netplay::GetConfirmedTick(session) >= config.ticks)
+			{
+				isDone = true;
+				doneCount++;
+			}
+
+			auto now = std::chrono::steady_clock::now();
+
+			if (!hasTicked)
+			{
+				next = now + std::chrono::milliseconds(1);
+			}
+			else
+			{
+				next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(period));
+
+				if (now - next > std::chrono::milliseconds(250))
+				{
+					next = now;
+				}
+			}
+		}
+	}
+
+	int Run(const Config& config)
+	{
+		Peer peers[2];
+
+		for (int i = 0; i < 2; i++)
+		{
+			Netplay::Config netConfig;
+			netConfig.localPlayer = i;
+			netConfig.localPort = static_cast<uint16_t>(config.basePort + i);
+			netConfig.remotePort = static_cast<uint16_t>(config.basePort + 1 - i);
+			netConfig.inputDelay = config.inputDelay;
+			netConfig.latencyMs = config.latencyMs;
+			netConfig.jitterMs = config.jitterMs;
+			netConfig.lossChance = config.lossChance;
+			netConfig.seed = config.seed + static_cast<uint64_t>(i);
+
+			peers[i].session.reset(new Netplay::Session());
+
+			if (!Netplay::Start(*peers[i].session, netConfig))
+			{
+				std::cerr << "could not open port " << netConfig.localPort << "\n";
+				return 1;
+			}
+		}
+
+		std::cout << "netplay over loopback: " << config.ticks << " ticks at " << config.tickRate << " Hz, latency " << config.latencyMs
+			<< " ms, jitter " << config.jitterMs << " ms, loss " << config.lossChance * 100.0f << "%, input delay " << config.inputDelay << "\n";
+
+		std::atomic<int> doneCount(0);
+
+		std::thread threads[2];
+
+		for (int i = 0; i < 2; i++)
+		{
+			threads[i] = std::thread(RunPeer, std::ref(peers[i]), std::cref(config), std::ref(doneCount));
+		}
+
+		for (int i = 0; i < 2; i++)
+		{
+			threads[i].join();
+		}
+
+		for (int i = 0; i < 2; i++)
+		{
+			Netplay::Stop(*peers[i].session);
+		}
+
+		size_t compared = std::min(peers[0].confirmed.size(), peers[1].confirmed.size());
+		long long firstMismatch = -1;
+
+		for (size_t tick = 0; tick < compared && firstMismatch < 0; tick++)
+		{
+			if (!Snapshot::IsEqual(peers[0].confirmed[tick], peers[1].confirmed[tick]))
+			{
+				firstMismatch = static_cast<long long>(tick);
+			}
+		}
+
+		for (int i = 0; i < 2; i++)
+		{
+			const Netplay::Stats& stats = peers[i].session->stats;
+
+			std::cout << "player " << i << ": " << peers[i].session->tick << " ticks, " << stats.rollbacks << " rollbacks (max " << stats.maxRollbackTicks
+				<< " ticks, worst resimulation " << stats.maxResimulateMs << " ms), " << stats.stalls << " stalls, "
+				<< stats.packetsSent << " sent, " << stats.packetsReceived << " received\n";
+		}
+
+		if (static_cast<long long>(compared) <= config.ticks)
+		{
+			std::cout << "timed out after " << compared << " confirmed ticks\n";
+			return 1;
+		}
+
+		if (firstMismatch >= 0)
+		{
+			std::cout << "desync at tick " << firstMismatch << "\n";
+			return 1;
+		}
+
+		std::cout << compared << " confirmed ticks identical on both peers\n";
+		return 0;
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+namespace NetplayTest
+{
+	struct Config
+	{
+		// Ticks both peers have to confirm before the run ends
+		int ticks = 7200;
+		float tickRate = 120.0f;
+		// 0 runs one update per tick. Otherwise peers run frames at this rate the way the game does: a poll every frame,
+		// then as many ticks as the time owed, so frames without a tick still take in inputs that call for a rollback
+		float frameRate = 0.0f;
+
+		int latencyMs = 40;
+		int jitterMs = 20;
+		float lossChance = 0.0f;
+		int inputDelay = 2;
+
+		uint16_t basePort = 7400;
+		uint64_t seed = 1;
+	};
+
+	// Runs two peers on their own threads over loopback and checks that every confirmed tick matches between them
+	int Run(const Config& config);
+}
@@ -1,56 +1,234 @@
 #include "obstacle.h"
 
 #include "globals.h"
+#include "canvas.h"
+#include "tuning.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace Obstacle
 {
 	namespace Variables
 	{
-	static float velocity = 500.0f;
 	static float offSet = 250.0f;
+
+	// What the sweeps return when nothing is hit within the step
+	const float noImpact = 2.0f;
 	}
 
-	void Initialization(Obstacle& obstacle)
+	static void SetGap(Obstacle& obstacle, Rng::Rng& rng, const Difficulty::Levels& levels, float fromTop, float fromBottom, float distance);
+	static bool CheckCollisionsCircleRectangle(float circleX, float circleY, float recX, float recY, float width, float height);
+
+	// Earliest fraction of the segment from start to start + move that is inside the shape, 0 if start already is
+	static float SweepBox(Vector2 start, Vector2 move, float minX, float minY, float maxX, float maxY);
+	static float SweepCircle(Vector2 start, Vector2 move, Vector2 center, float radius);
+	static float SweepCircleRectangle(Vector2 start, Vector2 move, float recX, float recY, float width, float height, float radius);
+
+	void SetGap(Obstacle& obstacle, Rng::Rng& rng, const Difficulty::Levels& levels, float fromTop, float fromBottom, float distance)
 	{
-		obstacle.width = 50.0f;
-		obstacle.height = 700.0f;
+		const Tuning::Tuning& tuning = Tuning::Get();
+
+		// Width and gap changes reach each obstacle when it respawns, so none resizes while on screen
+		obstacle.velocity = levels.obstacleVelocity;
+		obstacle.width = tuning.obstacleWidth;
+
+		float obstacleSpace = levels.gapSpace;
+		float offset = tuning.gapMargin;
+		float startX = static_cast<float>(Externs::screenWidth) + levels.obstacleSpacing;
+
+		// The bird's center went through between fromTop and fromBottom and has distance / velocity seconds to get in
+		// this gap. Flapping every tick it climbs at flapVelocity; falling from rest it drops gravity * time^2 / 2
+		float time = std::max(0.0f, distance) / obstacle.velocity;
+		float rise = tuning.flapVelocity * time;
+		float fall = std::max(0.0f, tuning.gravity) * time * time * 0.5f;
+		float radius = tuning.birdRadius;
+
+		// Gap tops for which the center can be between gap + radius and gap + obstacleSpace - radius in time
+		int lowest = static_cast<int>(offset);
+		int highest = static_cast<int>(Externs::screenHeight - offset - obstacleSpace);
+		float reachableLowest = fromTop - rise - obstacleSpace + radius;
+		float reachableHighest = fromBottom + fall - radius;
+
+		int minimum = std::max(lowest, static_cast<int>(std::ceil(std::max(reachableLowest, static_cast<float>(lowest)))));
+		int maximum = std::min(highest, static_cast<int>(std::floor(std::min(reachableHighest, static_cast<float>(highest)))));
 
-		float obstacleSpace = 200.0f;
-		float offset = 15.0f;
-		Vector2 gap = { static_cast<float>(Externs::screenWidth) , static_cast<float>(GetRandomValue(static_cast<int>(offset), static_cast<int>(Externs::screenHeight - offset - obstacleSpace))) };
-		obstacle.bottom = { static_cast<float>(Externs::screenWidth), gap.y - obstacle.height };
+		// Nothing on screen is reachable, which the difficulty check reports; the closest gap is the least bad
+		if (minimum > maximum)
+		{
+			minimum = maximum = reachableHighest < lowest ? lowest : highest;
+		}
+
+		Vector2 gap = { startX, static_cast<float>(Rng::Range(rng, minimum, maximum)) };
+		obstacle.bottom = { startX, gap.y - obstacle.height };
 		obstacle.top = { obstacle.bottom.x, gap.y + obstacleSpace };
+	}
 
-		obstacle.velocity = Variables::velocity;
+	void Initialization(Obstacle& obstacle, Rng::Rng& rng, const Difficulty::Levels& levels, Vector2 start)
+	{
+		obstacle.height = 700.0f;
+
+		float radius = Tuning::Get().birdRadius;
 
-		obstacle.passed = false;
+		SetGap(obstacle, rng, levels, start.y, start.y, Externs::screenWidth + levels.obstacleSpacing - start.x - radius);
+
+		obstacle.passed = 0;
 	}
 
-	void Update(Obstacle& obstacle)
+	void Move(Obstacle& obstacle, Rng::Rng& rng, float deltaT, const Difficulty::Levels& levels)
 	{
-		obstacle.bottom.x += -obstacle.velocity * Externs::deltaT;
+		obstacle.bottom.x += -obstacle.velocity * deltaT;
 		obstacle.top.x = obstacle.bottom.x;
 
 		if (CheckOutOfBounds(obstacle))
 		{
-			float obstacleSpace = 200.0f;
-			float offset = 15.0f;
-			Vector2 gap = { static_cast<float>(Externs::screenWidth) , static_cast<float>(GetRandomValue(static_cast<int>(offset), static_cast<int>(Externs::screenHeight - offset - obstacleSpace))) };
-			obstacle.bottom = { static_cast<float>(Externs::screenWidth), gap.y - obstacle.height };
-			obstacle.top = { obstacle.bottom.x, gap.y + obstacleSpace };
-			obstacle.passed = false;
+			// From leaving this obstacle, its right edge at the bird's left, to entering the next, its left edge at the bird's
+			// right: the bird's x drops out, and the pipes cover the screen and the spacing less the bird's width. Less a
+			// step, since the bird only gets whole ticks in between
+			float radius = Tuning::Get().birdRadius;
+			float distance = Externs::screenWidth + levels.obstacleSpacing - 2.0f * radius - levels.obstacleVelocity * deltaT;
+
+			SetGap(obstacle, rng, levels, obstacle.bottom.y + obstacle.height + radius, obstacle.top.y - radius, distance);
+			obstacle.passed = 0;
 		}
 	}
 
 	void Draw(Obstacle obstacle)
 	{
-		DrawRectangle(static_cast<int>(obstacle.bottom.x), static_cast<int>(obstacle.bottom.y), static_cast<int>(obstacle.width), static_cast<int>(obstacle.height), RED);
-		DrawRectangle(static_cast<int>(obstacle.top.x), static_cast<int>(obstacle.top.y), static_cast<int>(obstacle.width), static_cast<int>(obstacle.height), RED);
+		Canvas::DrawRectangle(static_cast<int>(obstacle.bottom.x), static_cast<int>(obstacle.bottom.y), static_cast<int>(obstacle.width), static_cast<int>(obstacle.height), RED);
+		Canvas::DrawRectangle(static_cast<int>(obstacle.top.x), static_cast<int>(obstacle.top.y), static_cast<int>(obstacle.width), static_cast<int>(obstacle.height), RED);
 	}
 
 	bool CheckOutOfBounds(Obstacle& obstacle)
 	{
 		return (obstacle.bottom.x + obstacle.width < 0.0f);
 	}
+
+	bool CheckCollision(Obstacle obstacle, Vector2 circle)
+	{
+		return CheckCollisionsCircleRectangle(circle.x, circle.y, obstacle.bottom.x, obstacle.bottom.y, obstacle.width, obstacle.height) ||
+			CheckCollisionsCircleRectangle(circle.x, circle.y, obstacle.top.x, obstacle.top.y, obstacle.width, obstacle.height);
+	}
+
+	bool CheckCollisionsCircleRectangle(float circleX, float circleY, float recX, float recY, float width, float height)
+	{
+		const float circleRadius = Tuning::Get().birdRadius;
+
+		float closestX = std::max(recX, std::min(circleX, recX + width));
+		float closestY = std::max(recY, std::min(circleY, recY + height));
+
+		float distanceX = circleX - closestX;
+		float distanceY = circleY - closestY;
+
+		float distanceSquared = (distanceX * distanceX) + (distanceY * distanceY);
+
+		if (distanceSquared < (circleRadius * circleRadius))
+		{
+			return true;
+		}
+		return false;
+	}
+
+	float GetImpactTime(const Obstacle& obstacle, float startX, Vector2 start, Vector2 end)
+	{
+		// Seen from the obstacle, which stands still where it is now, the bird moves in a straight line too
+		Vector2 relativeStart = { start.x + obstacle.bottom.x - startX, start.y };
+		Vector2 move = { end.x - relativeStart.x, end.y - relativeStart.y };
+
+		float radius = Tuning::Get().birdRadius;
+
+		return std::min(SweepCircleRectangle(relativeStart, move, obstacle.bottom.x, obstacle.bottom.y, obstacle.width, obstacle.height, radius),
+			SweepCircleRectangle(relativeStart, move, obstacle.top.x, obstacle.top.y, obstacle.width, obstacle.height, radius));
+	}
+
+	float SweepBox(Vector2 start, Vector2 move, float minX, float minY, float maxX, float maxY)
+	{
+		const float starts[2] = { start.x, start.y };
+		const float moves[2] = { move.x, move.y };
+		const float mins[2] = { minX, minY };
+		const float maxs[2] = { maxX, maxY };
+
+		float enter = 0.0f;
+		float exit = 1.0f;
+
+		// Slabs: the segment is inside the box over the overlap of the spans it spends inside each axis' bounds
+		for (int axis = 0; axis < 2; axis++)
+		{
+			if (moves[axis] == 0.0f)
+			{
+				if (starts[axis] < mins[axis] || starts[axis] > maxs[axis])
+				{
+					return Variables::noImpact;
+				}
+
+				continue;
+			}
+
+			float near = (mins[axis] - starts[axis]) / moves[axis];
+			float far = (maxs[axis] - starts[axis]) / moves[axis];
+
+			if (near > far)
+			{
+				std::swap(near, far);
+			}
+
+			enter = std::max(enter, near);
+			exit = std::min(exit, far);
+
+			if (enter > exit)
+			{
+				return Variables::noImpact;
+			}
+		}
+
+		return enter;
+	}
+
+	float SweepCircle(Vector2 start, Vector2 move, Vector2 center, float radius)
+	{
+		Vector2 offset = { start.x - center.x, start.y - center.y };
+
+		float a = move.x * move.x + move.y * move.y;
+		float b = offset.x * move.x + offset.y * move.y;
+		float c = offset.x * offset.x + offset.y * offset.y - radius * radius;
+
+		if (c <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		// Outside and moving away, or not moving at all
+		if (b >= 0.0f)
+		{
+			return Variables::noImpact;
+		}
+
+		float discriminant = b * b - a * c;
+
+		if (discriminant < 0.0f)
+		{
+			return Variables::noImpact;
+		}
+
+		float time = (-b - std::sqrt(discriminant)) / a;
+
+		return time <= 1.0f ? time : Variables::noImpact;
+	}
+
+	float SweepCircleRectangle(Vector2 start, Vector2 move, float recX, float recY, float width, float height, float radius)
+	{
+		// Every center closer than radius to the rectangle: two boxes grown along one axis each, and a circle at each corner
+		float time = std::min(SweepBox(start, move, recX - radius, recY, recX + width + radius, recY + height),
+			SweepBox(start, move, recX, recY - radius, recX + width, recY + height + radius));
+
+		const Vector2 corners[4] = { { recX, recY }, { recX + width, recY }, { recX, recY + height }, { recX + width, recY + height } };
+
+		for (const Vector2& corner : corners)
+		{
+			time = std::min(time, SweepCircle(start, move, corner, radius));
+		}
+
+		return time;
+	}
 }
 
@@ -1,6 +1,9 @@
 #pragma once
 #include "raylib.h"
 
+#include "difficulty.h"
+#include "rng.h"
+
 namespace Obstacle
 {
 	struct Obstacle
@@ -13,14 +16,23 @@ namespace Obstacle
 		float width;
 		float height;
 
-		bool passed;
+		// Bit i is set once player i got past it
+		uint8_t passed;
 
 		//Texture texture;
 	};
 
-	void Initialization(Obstacle& obstacle);
-	void Update(Obstacle& obstacle);
+	// New obstacles take the gap and spacing of levels; the speed is the caller's to keep up to date. Gaps are only
+	// placed where the bird can get to in time: the first from start, the bird's position, and the rest from the previous
+	void Initialization(Obstacle& obstacle, Rng::Rng& rng, const Difficulty::Levels& levels, Vector2 start);
+	void Move(Obstacle& obstacle, Rng::Rng& rng, float deltaT, const Difficulty::Levels& levels);
 	void Draw(Obstacle obstacle);
 
 	bool CheckOutOfBounds(Obstacle& obstacle);
+	bool CheckCollision(Obstacle obstacle, Vector2 circle);
+
+	// Swept CheckCollision: the bird moved in a straight line from start to end over a step in which the obstacle moved
+	// from startX to where it is now. Returns the fraction of the step at which they first touch, or more than 1 if they
+	// never do, so no speed or step length lets the bird pass through
+	float GetImpactTime(const Obstacle& obstacle, float startX, Vector2 start, Vector2 end);
 }
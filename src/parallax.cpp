@@ -0,0 +1,73 @@
+#include "parallax.h"
+
+#include "canvas.h"
+#include "globals.h"
+#include "utils.h"
+
+namespace Parallax
+{
+	namespace Assets
+	{
+		static Canvas::Sprite back;
+		static Canvas::Sprite middle;
+		static Canvas::Sprite front;
+	}
+
+	static void Scroll(float& offset, float speed, float deltaT);
+	static void DrawLayer(const Canvas::Sprite& sprite, float offset);
+
+	void Scroll(float& offset, float speed, float deltaT)
+	{
+		offset -= speed * deltaT;
+
+		if (offset <= -200.0f)
+		{
+			offset = 0;
+		}
+	}
+
+	void DrawLayer(const Canvas::Sprite& sprite, float offset)
+	{
+		// Each layer is two screens wide and drawn twice, so the seam scrolls through
+		float width = Utils::PercentToPixelsX(200.0f);
+		float height = Utils::PercentToPixelsY(100.0f);
+
+		Canvas::DrawSprite(sprite, Utils::PercentToPixelsX(offset), 0.0f, width, height, WHITE);
+		Canvas::DrawSprite(sprite, Utils::PercentToPixelsX(200.0f + offset), 0.0f, width, height, WHITE);
+	}
+
+	void Load()
+	{
+		Canvas::LoadSprite(Assets::front, Externs::backgroundFrontTexture);
+		Canvas::LoadSprite(Assets::middle, Externs::backgroundMiddleTexture);
+		Canvas::LoadSprite(Assets::back, Externs::backgroundBackTexture);
+	}
+
+	void Unload()
+	{
+		Canvas::UnloadSprite(Assets::front);
+		Canvas::UnloadSprite(Assets::middle);
+		Canvas::UnloadSprite(Assets::back);
+	}
+
+	void Reset(Layers& layers)
+	{
+		layers.back = 0.0f;
+		layers.middle = 0.0f;
+		layers.front = 0.0f;
+	}
+
+	void Update(Layers& layers, float deltaT)
+	{
+		Scroll(layers.back, 1.0f, deltaT);
+		Scroll(layers.middle, 2.0f, deltaT);
+		Scroll(layers.front, 4.0f, deltaT);
+	}
+
+	void Draw(const Layers& layers)
+	{
+		DrawLayer(Assets::back, layers.back);
+		DrawLayer(Assets::middle, layers.middle);
+		DrawLayer(Assets::front, layers.front);
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace Parallax
+{
+	// Scroll offsets in percent of the screen width, one per layer
+	struct Layers
+	{
+		float back;
+		float middle;
+		float front;
+	};
+
+	void Load();
+	void Unload();
+
+	void Reset(Layers& layers);
+	void Update(Layers& layers, float deltaT);
+	void Draw(const Layers& layers);
+}
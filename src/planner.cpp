@@ -0,0 +1,386 @@
+#include "planner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+#include "tuning.h"
+
+namespace Planner
+{
+	typedef std::chrono::steady_clock Clock;
+
+	enum class Result
+	{
+		Found, Failed, OutOfTime
+	};
+
+	static bool IsAlive(const Planner& planner, const World::World& world);
+	static bool Step(Planner& planner, int from, bool isFlapping);
+	static bool IsFlapPreferred(const Planner& planner, int index);
+	static void SetPlan(Planner& planner, int length);
+	static uint64_t GetKey(const Planner& planner, int index);
+	static size_t GetSlot(uint64_t key);
+	static bool IsKnownFailure(const Planner& planner, uint64_t key);
+	static void AddFailure(Planner& planner, uint64_t key);
+	static Result TryFlap(Planner& planner, int first, int flap, Clock::time_point deadline);
+	static Result Search(Planner& planner, int first, Clock::time_point deadline);
+
+	bool IsAlive(const Planner& planner, const World::World& world)
+	{
+		return !world.hasLost && world.birds[planner.player].isOn;
+	}
+
+	bool Step(Planner& planner, int from, bool isFlapping)
+	{
+		World::World& next = planner.nodes[from + 1];
+		next = planner.nodes[from];
+
+		planner.step(next, isFlapping ? static_cast<World::Input>(1 << planner.player) : 0);
+		planner.stats.steps++;
+
+		return IsAlive(planner, next);
+	}
+
+	bool IsFlapPreferred(const Planner& planner, int index)
+	{
+		const World::World& world = planner.nodes[index];
+		const Player::Bird& bird = world.birds[planner.player];
+
+		if (planner.hint != nullptr)
+		{
+			return Policy::Evaluate(*planner.hint, World::Observe(bird, world.obstacle));
+		}
+
+		// Otherwise flap once the bird is about to sink past the lowest it can be in the gap, so it hovers at the bottom
+		// of the gap. Aiming for the middle overshoots, a flap is about as tall as a gap
+		const World::World& next = planner.nodes[index + 1];
+
+		return next.birds[planner.player].position.y > world.obstacle.top.y - Tuning::Get().birdRadius;
+	}
+
+	void SetPlan(Planner& planner, int length)
+	{
+		// Anytime: the path the bird lives longest on is the plan if the budget runs out
+		if (length > planner.planLength)
+		{
+			planner.planLength = length;
+			std::copy(planner.path, planner.path + length, planner.plan);
+		}
+	}
+
+	uint64_t GetKey(const Planner& planner, int index)
+	{
+		// Birds within a pixel and a few pixels per second of each other on the same tick go the same way; the obstacle
+		// is the same for every node on a tick
+		const Player::Bird& bird = planner.nodes[index].birds[planner.player];
+
+		uint64_t y = static_cast<uint16_t>(static_cast<int>(std::floor(bird.position.y)));
+		uint64_t velocity = static_cast<uint16_t>(static_cast<int>(std::floor(bird.velocity / 8.0f)));
+
+		return (planner.generation << 48) | (static_cast<uint64_t>(index) << 32) | (y << 16) | velocity;
+	}
+
+	size_t GetSlot(uint64_t key)
+	{
+		return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 40) % failureCapacity;
+	}
+
+	bool IsKnownFailure(const Planner& planner, uint64_t key)
+	{
+		size_t slot = GetSlot(key);
+
+		for (int probe = 0; probe < 8; probe++)
+		{
+			uint64_t entry = planner.failures[(slot + probe) % failureCapacity];
+
+			if (entry == key)
+			{
+				return true;
+			}
+
+			if (entry == 0)
+			{
+				return false;
+			}
+		}
+
+		return false;
+	}
+
+	void AddFailure(Planner& planner, uint64_t key)
+	{
+		size_t slot = GetSlot(key);
+
+		// Entries from older searches are free to take
+		for (int probe = 0; probe < 8; probe++)
+		{
+			uint64_t& entry = planner.failures[(slot + probe) % failureCapacity];
+
+			if (entry == 0 || (entry >> 48) != planner.generation)
+			{
+				entry = key;
+				return;
+			}
+		}
+	}
+
+	Result TryFlap(Planner& planner, int first, int flap, Clock::time_point deadline)
+	{
+		std::fill(planner.path + first, planner.path + flap, false);
+		planner.path[flap] = true;
+
+		if (!Step(planner, flap, true))
+		{
+			return Result::Failed;
+		}
+
+		SetPlan(planner, flap + 1);
+
+		return Search(planner, flap + 1, deadline);
+	}
+
+	Result Search(Planner& planner, int first, Clock::time_point deadline)
+	{
+		// nodes[first] is alive; what remains is when to flap next
+		if (first >= planner.horizon)
+		{
+			return Result::Found;
+		}
+
+		if (Clock::now() >= deadline)
+		{
+			planner.isOutOfTime = true;
+			return Result::OutOfTime;
+		}
+
+		uint64_t key = GetKey(planner, first);
+
+		if (IsKnownFailure(planner, key))
+		{
+			return Result::Failed;
+		}
+
+		// Let the bird fall to see how long it could wait, and where the guide would flap
+		int last = first;
+		int preferred = -1;
+
+		while (last < planner.horizon)
+		{
+			bool isAlive = Step(planner, last, false);
+
+			if (preferred < 0 && IsFlapPreferred(planner, last))
+			{
+				preferred = last;
+			}
+
+			if (!isAlive)
+			{
+				break;
+			}
+
+			last++;
+		}
+
+		std::fill(planner.path + first, planner.path + last, false);
+		SetPlan(planner, last);
+
+		if (last == planner.horizon)
+		{
+			return Result::Found;
+		}
+
+		// Flapping on any tick from first to last is possible. The preferred one goes first, then earlier ones while
+		// nodes still holds the fall up to them, then later ones stepping the fall again
+		if (preferred < 0)
+		{
+			preferred = last;
+		}
+
+		for (int flap = preferred; flap >= first; flap--)
+		{
+			Result result = TryFlap(planner, first, flap, deadline);
+
+			if (result != Result::Failed)
+			{
+				return result;
+			}
+		}
+
+		for (int flap = preferred + 1; flap <= last; flap++)
+		{
+			Step(planner, flap - 1, false);
+
+			Result result = TryFlap(planner, first, flap, deadline);
+
+			if (result != Result::Failed)
+			{
+				return result;
+			}
+		}
+
+		AddFailure(planner, key);
+		return Result::Failed;
+	}
+
+	void Reset(Planner& planner, const Config& config, int player, const Policy::Network* hint)
+	{
+		planner.config = config;
+		planner.player = player;
+		planner.hint = hint;
+
+		planner.planTick = 0;
+		planner.planLength = 0;
+		planner.isComplete = false;
+
+		planner.stats = Stats();
+
+		std::memset(planner.failures, 0, sizeof(planner.failures));
+		planner.generation = 0;
+	}
+
+	void Plan(Planner& planner, const World::World& world)
+	{
+		Clock::time_point start = Clock::now();
+		Clock::time_point deadline = start + std::chrono::microseconds(static_cast<long long>(planner.config.budgetMs * 1000.0f));
+
+		// Kept in case the search comes up shorter. It is not used as a guide: a plan that ran into trouble at the new end of
+		// the horizon usually has to change early on, and backing up from the end to there takes far longer than starting over
+		int oldLength = planner.planTick <= world.tick ? std::max(0, planner.planLength - static_cast<int>(world.tick - planner.planTick)) : 0;
+		bool oldPlan[maxTicks];
+		std::copy(planner.plan + planner.planLength - oldLength, planner.plan + planner.planLength, oldPlan);
+
+		planner.horizon = std::max(1, std::min(maxTicks, static_cast<int>(std::ceil(planner.config.horizonSeconds / world.deltaT))));
+		planner.step = World::GetStep(world.playerCount);
+		planner.isOutOfTime = false;
+		planner.generation = (planner.generation + 1) & 0xFFFF;
+
+		planner.nodes[0] = world;
+		planner.planTick = world.tick;
+		planner.planLength = 0;
+		planner.isComplete = false;
+
+		if (IsAlive(planner, world) && planner.config.isAssisting)
+		{
+			// Assisting, first look for a way through that leaves the bird alone for a while. If there is one the player
+			// still has time to find it, otherwise the search takes over with what budget is left
+			int reaction = std::min(planner.horizon, static_cast<int>(std::ceil(planner.config.reactionSeconds / world.deltaT)));
+			int tick = 0;
+
+			while (tick < reaction && Step(planner, tick, false))
+			{
+				tick++;
+			}
+
+			std::fill(planner.path, planner.path + tick, false);
+
+			planner.isComplete = tick == reaction && Search(planner, tick, start + (deadline - start) / 2) == Result::Found;
+			planner.planLength = planner.isComplete ? planner.planLength : 0;
+		}
+
+		if (IsAlive(planner, world) && !planner.isComplete)
+		{
+			planner.isComplete = Search(planner, 0, deadline) == Result::Found;
+		}
+
+		// The world went the way the old plan said, so what is left of it still holds
+		if (!planner.isComplete && oldLength > planner.planLength)
+		{
+			planner.planLength = oldLength;
+			std::copy(oldPlan, oldPlan + oldLength, planner.plan);
+		}
+
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		planner.stats.searches++;
+		planner.stats.timeouts += planner.isOutOfTime ? 1 : 0;
+		planner.stats.lastMs = ms;
+		planner.stats.totalMs += ms;
+		planner.stats.worstMs = std::max(planner.stats.worstMs, ms);
+	}
+
+	bool IsBirdMoving(const Planner& planner, const World::World& world)
+	{
+		uint64_t index = world.tick - planner.planTick;
+
+		return world.tick >= planner.planTick && index < static_cast<uint64_t>(planner.planLength) && planner.plan[index];
+	}
+
+	int RunTrials(const TrialConfig& config)
+	{
+		if (config.rounds < 1 || config.frameRate < 1 || !(config.deltaT > 0.0f) || !(config.maxTime > 0.0f) || !(config.planner.budgetMs > 0.0f)
+			|| !(config.planner.horizonSeconds > 0.0f))
+		{
+			std::cerr << "rounds, frame rate, dt, max time, budget and horizon must be positive\n";
+			return 1;
+		}
+
+		// Too big for the stack with all its world copies
+		std::unique_ptr<Planner> planner(new Planner());
+		World::World world;
+
+		int cleared = 0;
+		long long totalScore = 0;
+		int worstScore = -1;
+		double simulated = 0.0;
+		double planning = 0.0;
+		double worstMs = 0.0;
+		unsigned long long searches = 0;
+		unsigned long long timeouts = 0;
+		unsigned long long steps = 0;
+
+		float frameTime = 1.0f / config.frameRate;
+
+		Clock::time_point start = Clock::now();
+
+		for (int round = 0; round < config.rounds; round++)
+		{
+			World::Reset(world, 1, config.seed + static_cast<uint64_t>(round));
+			world.deltaT = config.deltaT;
+
+			World::StepFunction step = World::GetStep(world.playerCount);
+			Reset(*planner, config.planner, 0, nullptr);
+
+			float accumulator = 0.0f;
+
+			while (!world.hasLost && world.timeAlive < config.maxTime)
+			{
+				// One plan per frame, then however many ticks the frame holds, like the game loop
+				Plan(*planner, world);
+				accumulator += frameTime;
+
+				while (accumulator >= world.deltaT && !world.hasLost)
+				{
+					step(world, IsBirdMoving(*planner, world) ? 1 : 0);
+					accumulator -= world.deltaT;
+				}
+			}
+
+			cleared += world.hasLost ? 0 : 1;
+			totalScore += world.score;
+			worstScore = worstScore < 0 ? world.score : std::min(worstScore, world.score);
+			simulated += world.timeAlive;
+
+			const Stats& stats = planner->stats;
+
+			planning += stats.totalMs;
+			searches += stats.searches;
+			timeouts += stats.timeouts;
+			steps += stats.steps;
+			worstMs = std::max(worstMs, stats.worstMs);
+		}
+
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		std::cout << config.rounds << " rounds, " << cleared << " survived " << config.maxTime << " s, score " << static_cast<double>(totalScore) / config.rounds
+			<< " on average and " << worstScore << " at worst\n";
+		std::cout << searches << " plans: " << planning / std::max<unsigned long long>(1, searches) << " ms on average, " << worstMs << " ms at worst against a budget of " << config.planner.budgetMs
+			<< " ms, " << timeouts << " out of time, " << static_cast<double>(steps) / std::max<unsigned long long>(1, searches) << " ticks stepped each\n";
+		std::cout << simulated << " s played in " << seconds << " s, " << simulated / std::max(seconds, 1e-9) << "x real time\n";
+
+		return 0;
+	}
+}
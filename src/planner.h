@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+
+#include "policy.h"
+#include "world.h"
+
+// An autopilot that looks for a run of flaps keeping one bird alive over the next second. It steps copies of the world
+// depth first, branching on when the next flap comes, latest first from where a simple rule would flap. The search
+// stops when its time budget runs out and keeps the longest plan it found, or the last frame's if that one goes further
+namespace Planner
+{
+	const int maxTicks = 256;
+	const int failureCapacity = 2048;
+
+	struct Config
+	{
+		// Time one Plan call may take
+		float budgetMs = 0.5f;
+		float horizonSeconds = 1.0f;
+
+		// Leaves the flapping to the player unless the bird has to flap within reactionSeconds to make it
+		bool isAssisting = false;
+		float reactionSeconds = 0.25f;
+	};
+
+	struct Stats
+	{
+		unsigned long long searches = 0;
+		unsigned long long steps = 0;
+		unsigned long long timeouts = 0;
+
+		double lastMs = 0.0;
+		double totalMs = 0.0;
+		double worstMs = 0.0;
+	};
+
+	struct Planner
+	{
+		Config config;
+		int player;
+
+		// Picks the flap tried first instead of the rule; optional
+		const Policy::Network* hint;
+
+		// plan[i] is whether to flap on tick planTick + i. The bird lives through the first planLength ticks; through
+		// the whole horizon when isComplete
+		uint64_t planTick;
+		int planLength;
+		bool plan[maxTicks];
+		bool isComplete;
+
+		Stats stats;
+
+		// Search state. nodes[i] is the world i ticks after the root along the path being tried
+		World::World nodes[maxTicks + 1];
+		bool path[maxTicks];
+		int horizon;
+		World::StepFunction step;
+		bool isOutOfTime;
+
+		// Searched states that can't live to the horizon, tagged with the search they came from
+		uint64_t failures[failureCapacity];
+		uint64_t generation;
+	};
+
+	void Reset(Planner& planner, const Config& config, int player, const Policy::Network* hint);
+
+	// Searches from the world as it is now for up to the budget. Call once a frame, before its ticks
+	void Plan(Planner& planner, const World::World& world);
+
+	// Whether the plan flaps the bird on the tick world is about to take
+	bool IsBirdMoving(const Planner& planner, const World::World& world);
+
+	struct TrialConfig
+	{
+		int rounds = 20;
+		// Rounds the bird survives this long count as cleared
+		float maxTime = 120.0f;
+		int frameRate = 60;
+
+		float deltaT = World::defaultDeltaT;
+		uint64_t seed = 1;
+
+		Config planner;
+	};
+
+	// Plays rounds with the planner at the wheel, planning once per frame as the game does, and prints how far it got
+	// and what the planning cost
+	int RunTrials(const TrialConfig& config);
+}
@@ -1,5 +1,7 @@
 #include "player.h"
 #include "globals.h"
+#include "canvas.h"
+#include "tuning.h"
 
 #include <iostream>
 
@@ -11,43 +13,34 @@ namespace Player
 		static Sound fall;
 	}
 
-	namespace Variables
+	void Initialization(Bird& bird, Vector2 pos)
 	{
-		static float velocity = 500.0f;
-	}
-
-	void Initialization(Bird& bird, KeyboardKey moveUpKey, Vector2 pos)
-	{
-		Assets::flap = LoadSound(Externs::flapSound.c_str());
-		Assets::fall = LoadSound(Externs::birdFallSound.c_str());
-
 		bird.position = pos;
 
 		bird.velocity = 0.0f;
 
 		bird.isOn = true;
-
-		bird.moveUpKey = moveUpKey;
 	}
 
-	void Update(Bird& bird)
+	void Move(Bird& bird, bool isMoving, float deltaT)
 	{
-		bird.velocity -= Globals::acceleration * Externs::deltaT;
+		const Tuning::Tuning& tuning = Tuning::Get();
+
+		bird.velocity -= tuning.gravity * deltaT;
 
-		if (IsPlayerMoving(bird.moveUpKey))
+		if (isMoving)
 		{
-			bird.velocity = Variables::velocity;
-			PlaySound(Assets::flap);
+			bird.velocity = tuning.flapVelocity;
 		}
 
-		bird.position.y -= bird.velocity * Externs::deltaT;
+		bird.position.y -= bird.velocity * deltaT;
 
 		CheckState(bird);
 	}
 
-	void Draw(Bird bird)
+	void Draw(Bird bird, Color color)
 	{
-		DrawCircleV(bird.position, 30.0f, BLUE);
+		Canvas::DrawCircle(bird.position, Tuning::Get().birdRadius, color);
 	}
 
 	bool IsPlayerMoving(KeyboardKey moveUpKey)
@@ -57,12 +50,14 @@ namespace Player
 
 	bool HasLost(Bird bird)
 	{
-		return bird.position.y - (30.0f / 2.0f) > (Externs::screenHeight + 30.0f);
+		float radius = Tuning::Get().birdRadius;
+
+		return bird.position.y - (radius / 2.0f) > (Externs::screenHeight + radius);
 	}
 
 	bool IsTouchingCeiling(Bird bird)
 	{
-		return (bird.position.y - 30.0f) < 0;
+		return (bird.position.y - Tuning::Get().birdRadius) < 0;
 	}
 
 	void CheckState(Bird& bird)
@@ -70,15 +65,30 @@ namespace Player
 		if (HasLost(bird))
 		{
 			bird.isOn = false;
-			PlaySound(Assets::fall);
 		}
 		if (IsTouchingCeiling(bird))
 		{
-			bird.position.y = 30.0f;
+			bird.position.y = Tuning::Get().birdRadius;
 			bird.velocity = 0.0f;
 		}
 	}
 
+	void LoadSounds()
+	{
+		Assets::flap = LoadSound(Externs::flapSound.c_str());
+		Assets::fall = LoadSound(Externs::birdFallSound.c_str());
+	}
+
+	void PlayFlapSound()
+	{
+		PlaySound(Assets::flap);
+	}
+
+	void PlayFallSound()
+	{
+		PlaySound(Assets::fall);
+	}
+
 	void UnloadSounds()
 	{
 		UnloadSound(Assets::flap);
@@ -11,16 +11,14 @@ namespace Player
 
 		bool isOn;
 
-		KeyboardKey moveUpKey;
-
 		//Texture texture;
 	};
 
 	
 
-	void Initialization(Bird& bird, KeyboardKey moveUpKey, Vector2 pos);
-	void Update(Bird& bird);
-	void Draw(Bird bird);
+	void Initialization(Bird& bird, Vector2 pos);
+	void Move(Bird& bird, bool isMoving, float deltaT);
+	void Draw(Bird bird, Color color);
 
 	bool IsPlayerMoving(KeyboardKey moveUpKey);
 
@@ -28,5 +26,8 @@ namespace Player
 	bool HasLost(Bird bird);
 
 	void CheckState(Bird& bird);
+	void LoadSounds();
+	void PlayFlapSound();
+	void PlayFallSound();
 	void UnloadSounds();
 }
\ No newline at end of file
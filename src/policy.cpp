@@ -0,0 +1,129 @@
+#include "policy.h"
+
+#include <cmath>
+#include <fstream>
+
+#include "globals.h"
+
+namespace Policy
+{
+	namespace Variables
+	{
+		const char* fileHeader = "flappy-policy";
+		const int fileVersion = 1;
+
+		const float velocityScale = 1.0f / 500.0f;
+	}
+
+	static float Gaussian(Rng::Rng& rng);
+
+	float Gaussian(Rng::Rng& rng)
+	{
+		float u1 = Rng::Float(rng);
+		float u2 = Rng::Float(rng);
+
+		if (u1 < 1e-7f)
+		{
+			u1 = 1e-7f;
+		}
+
+		return std::sqrt(-2.0f * std::log(u1)) * std::cos(6.2831853f * u2);
+	}
+
+	void Randomize(Network& network, Rng::Rng& rng, float scale)
+	{
+		for (int i = 0; i < weightCount; i++)
+		{
+			network.weights[i] = Gaussian(rng) * scale;
+		}
+	}
+
+	void Mutate(Network& network, Rng::Rng& rng, float rate, float scale)
+	{
+		for (int i = 0; i < weightCount; i++)
+		{
+			if (Rng::Float(rng) < rate)
+			{
+				network.weights[i] += Gaussian(rng) * scale;
+			}
+		}
+	}
+
+	bool Evaluate(const Network& network, World::Observation observation)
+	{
+		float inputs[inputCount] =
+		{
+			observation.birdY / Externs::screenHeight,
+			observation.birdVelocity * Variables::velocityScale,
+			(observation.gapY - observation.birdY) / Externs::screenHeight,
+			observation.gapDistance / Externs::screenWidth
+		};
+
+		const float* hiddenWeights = network.weights;
+		const float* outputWeights = network.weights + hiddenCount * (inputCount + 1);
+
+		float output = outputWeights[hiddenCount];
+
+		for (int h = 0; h < hiddenCount; h++)
+		{
+			const float* row = hiddenWeights + h * (inputCount + 1);
+			float sum = row[0];
+
+			for (int i = 0; i < inputCount; i++)
+			{
+				sum += row[i + 1] * inputs[i];
+			}
+
+			output += std::tanh(sum) * outputWeights[h];
+		}
+
+		return output > 0.0f;
+	}
+
+	bool Save(const Network& network, const std::string& path)
+	{
+		std::ofstream file(path);
+
+		if (!file)
+		{
+			return false;
+		}
+
+		file << Variables::fileHeader << " " << Variables::fileVersion << " " << weightCount << "\n";
+		file.precision(9);
+
+		for (int i = 0; i < weightCount; i++)
+		{
+			file << network.weights[i] << "\n";
+		}
+
+		return static_cast<bool>(file);
+	}
+
+	bool Load(Network& network, const std::string& path)
+	{
+		std::ifstream file(path);
+
+		std::string header;
+		int version = 0;
+		int count = 0;
+
+		if (!(file >> header >> version >> count) || header != Variables::fileHeader || version != Variables::fileVersion || count != weightCount)
+		{
+			return false;
+		}
+
+		Network loaded;
+
+		for (int i = 0; i < weightCount; i++)
+		{
+			if (!(file >> loaded.weights[i]))
+			{
+				return false;
+			}
+		}
+
+		network = loaded;
+		return true;
+	}
+}
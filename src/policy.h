@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+
+#include "rng.h"
+#include "world.h"
+
+namespace Policy
+{
+	const int inputCount = 4;
+	const int hiddenCount = 8;
+	const int weightCount = hiddenCount * (inputCount + 1) + hiddenCount + 1;
+
+	// inputs -> tanh hidden layer -> single output, flap when the output is positive.
+	// Stored as one (bias, inputs...) row per hidden neuron, then the output weights and the output bias
+	struct Network
+	{
+		float weights[weightCount];
+	};
+
+	void Randomize(Network& network, Rng::Rng& rng, float scale);
+	void Mutate(Network& network, Rng::Rng& rng, float rate, float scale);
+
+	bool Evaluate(const Network& network, World::Observation observation);
+
+	bool Save(const Network& network, const std::string& path);
+	bool Load(Network& network, const std::string& path);
+}
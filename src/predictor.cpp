@@ -0,0 +1,184 @@
+#include "predictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "tuning.h"
+
+namespace Predictor
+{
+	// Height after n ticks of free flight, where u is the velocity the first tick ends with:
+	// y(n) = y0 - deltaT * (n * u - gravity * deltaT * n * (n - 1) / 2), a quadratic a * n^2 + b * n + y0
+	struct Flight
+	{
+		float startY;
+		float firstVelocity;
+
+		float a;
+		float b;
+	};
+
+	static Flight GetFlight(float startY, float firstVelocity, float deltaT);
+	static double GetHeight(const Flight& flight, double ticks);
+	static int GetFirstTickAbove(const Flight& flight, float y, int maxTicks);
+	static int GetFirstTickBelow(const Flight& flight, float y, int maxTicks);
+	static int GetFirstNegative(double a, double b, double c, int maxTicks);
+
+	Flight GetFlight(float startY, float firstVelocity, float deltaT)
+	{
+		float gravity = Tuning::Get().gravity;
+
+		Flight flight;
+		flight.startY = startY;
+		flight.firstVelocity = firstVelocity;
+		flight.a = gravity * deltaT * deltaT * 0.5f;
+		flight.b = -deltaT * firstVelocity - flight.a;
+
+		return flight;
+	}
+
+	double GetHeight(const Flight& flight, double ticks)
+	{
+		return (static_cast<double>(flight.a) * ticks + flight.b) * ticks + flight.startY;
+	}
+
+	int GetFirstNegative(double a, double b, double c, int maxTicks)
+	{
+		// Smallest whole n in 1..maxTicks with a * n^2 + b * n + c < 0, from the roots; maxTicks + 1 if there is none
+		auto isNegative = [&](double n) { return (a * n + b) * n + c < 0.0; };
+
+		double candidate = 1.0;
+
+		if (a == 0.0)
+		{
+			if (b < 0.0)
+			{
+				candidate = std::floor(-c / b) + 1.0;
+			}
+		}
+		else
+		{
+			double discriminant = b * b - 4.0 * a * c;
+
+			if (discriminant > 0.0)
+			{
+				double root = std::sqrt(discriminant);
+				double low = (-b - (a > 0.0 ? root : -root)) / (2.0 * a);
+				double high = (-b + (a > 0.0 ? root : -root)) / (2.0 * a);
+
+				// Opening up it is negative between the roots, opening down past the larger one
+				if (a > 0.0 && high <= 1.0)
+				{
+					return maxTicks + 1;
+				}
+
+				candidate = a > 0.0 ? std::floor(low) + 1.0 : (isNegative(1.0) ? 1.0 : std::floor(high) + 1.0);
+			}
+			else if (a > 0.0)
+			{
+				return maxTicks + 1;
+			}
+		}
+
+		candidate = std::max(1.0, std::min(candidate, static_cast<double>(maxTicks) + 1.0));
+
+		// The roots are floats off by a hair at most; settle on the exact tick
+		while (candidate > 1.0 && isNegative(candidate - 1.0))
+		{
+			candidate -= 1.0;
+		}
+
+		while (candidate <= maxTicks && !isNegative(candidate))
+		{
+			candidate += 1.0;
+		}
+
+		return static_cast<int>(candidate);
+	}
+
+	int GetFirstTickAbove(const Flight& flight, float y, int maxTicks)
+	{
+		return GetFirstNegative(flight.a, flight.b, static_cast<double>(flight.startY) - y, maxTicks);
+	}
+
+	int GetFirstTickBelow(const Flight& flight, float y, int maxTicks)
+	{
+		return GetFirstNegative(-static_cast<double>(flight.a), -static_cast<double>(flight.b), static_cast<double>(y) - flight.startY, maxTicks);
+	}
+
+	Player::Bird GetState(Player::Bird bird, bool isFlapping, int ticks, float deltaT)
+	{
+		if (ticks <= 0)
+		{
+			return bird;
+		}
+
+		const Tuning::Tuning& tuning = Tuning::Get();
+		float radius = tuning.birdRadius;
+
+		Flight flight = GetFlight(bird.position.y, isFlapping ? tuning.flapVelocity : bird.velocity - tuning.gravity * deltaT, deltaT);
+
+		// Touching the ceiling stops the bird there; from then on it falls from rest, or stays if nothing pulls it down
+		int ceiling = GetFirstTickAbove(flight, radius, ticks);
+
+		if (ceiling <= ticks)
+		{
+			if (tuning.gravity <= 0.0f)
+			{
+				bird.position.y = radius;
+				bird.velocity = 0.0f;
+				return bird;
+			}
+
+			flight = GetFlight(radius, -tuning.gravity * deltaT, deltaT);
+			ticks -= ceiling;
+		}
+
+		bird.position.y = static_cast<float>(GetHeight(flight, ticks));
+		bird.velocity = ticks > 0 ? flight.firstVelocity - (ticks - 1) * tuning.gravity * deltaT : 0.0f;
+
+		// Free flight is a parabola opening down the screen, so the lowest point of the stretch is at one of its ends
+		bird.isOn = bird.isOn && !Player::HasLost(bird);
+
+		return bird;
+	}
+
+	int GetTicksUntilBelow(Player::Bird bird, bool isFlapping, float y, float deltaT, int maxTicks)
+	{
+		const Tuning::Tuning& tuning = Tuning::Get();
+		float radius = tuning.birdRadius;
+
+		Flight flight = GetFlight(bird.position.y, isFlapping ? tuning.flapVelocity : bird.velocity - tuning.gravity * deltaT, deltaT);
+
+		int ceiling = GetFirstTickAbove(flight, radius, maxTicks);
+		int below = GetFirstTickBelow(flight, y, maxTicks);
+
+		if (ceiling < below && tuning.gravity > 0.0f)
+		{
+			flight = GetFlight(radius, -tuning.gravity * deltaT, deltaT);
+			below = ceiling + GetFirstTickBelow(flight, y, maxTicks - ceiling);
+		}
+		else if (ceiling < below)
+		{
+			below = radius > y ? ceiling : maxTicks + 1;
+		}
+
+		return below <= maxTicks ? below : -1;
+	}
+
+	int GetPath(Player::Bird bird, bool isFlapping, float seconds, float deltaT, float forwardSpeed, Vector2* points, int maxPoints)
+	{
+		int ticks = static_cast<int>(seconds / deltaT);
+		int count = std::min(maxPoints, ticks);
+
+		for (int i = 0; i < count; i++)
+		{
+			int tick = static_cast<int>(static_cast<long long>(ticks) * (i + 1) / count);
+			Player::Bird state = GetState(bird, isFlapping, tick, deltaT);
+
+			points[i] = { bird.position.x + forwardSpeed * tick * deltaT, state.position.y };
+		}
+
+		return count;
+	}
+}
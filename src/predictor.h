@@ -0,0 +1,18 @@
+#pragma once
+#include "player.h"
+
+// Where a bird will be, worked out in closed form from the tick rule in Player::Move instead of by stepping: a tick
+// takes gravity off the velocity, a flap sets it, and the bird moves by the velocity. Matches the simulation up to
+// float rounding, ceiling included, so bots can look any number of ticks ahead at constant cost
+namespace Predictor
+{
+	// The bird after ticks steps of deltaT, flapping on the first one or not at all
+	Player::Bird GetState(Player::Bird bird, bool isFlapping, int ticks, float deltaT);
+
+	// First tick after which the bird is lower on screen than y, or -1 if that takes more than maxTicks
+	int GetTicksUntilBelow(Player::Bird bird, bool isFlapping, float y, float deltaT, int maxTicks);
+
+	// The path over the next seconds, sampled at up to maxPoints evenly spaced ticks. x moves at forwardSpeed, the speed
+	// obstacles come at, so the path lines up with them on screen. Returns the number of points written
+	int GetPath(Player::Bird bird, bool isFlapping, float seconds, float deltaT, float forwardSpeed, Vector2* points, int maxPoints);
+}
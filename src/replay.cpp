@@ -0,0 +1,250 @@
+#include "replay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "state_hash.h"
+
+namespace Replay
+{
+	namespace Variables
+	{
+		const char* fileHeader = "flappy-replay";
+		const int fileVersion = 3;
+
+		// Written as its 32 bit words, so the floats come back to the bit
+		const size_t tuningWords = sizeof(Tuning::Tuning) / sizeof(uint32_t);
+	}
+
+	static_assert(sizeof(Tuning::Tuning) % sizeof(uint32_t) == 0, "Tuning must be whole 32 bit words");
+
+	static bool IsSameTuning(const Tuning::Tuning& a, const Tuning::Tuning& b);
+
+	bool IsSameTuning(const Tuning::Tuning& a, const Tuning::Tuning& b)
+	{
+		return std::memcmp(&a, &b, sizeof(Tuning::Tuning)) == 0;
+	}
+
+	void Begin(Replay& replay, const World::World& world)
+	{
+		replay.seed = world.seed;
+		replay.playerCount = world.playerCount;
+		replay.deltaT = world.deltaT;
+		replay.inputs.clear();
+		replay.tunings.assign(1, { 0, Tuning::Get() });
+		replay.finalHash = 0;
+	}
+
+	void Record(Replay& replay, World::Input input)
+	{
+		const Tuning::Tuning& tuning = Tuning::Get();
+		uint64_t tick = replay.inputs.size();
+
+		if (!IsSameTuning(tuning, replay.tunings.back().tuning))
+		{
+			// Two changes before the same tick only need the last
+			if (replay.tunings.back().tick == tick)
+			{
+				replay.tunings.back().tuning = tuning;
+			}
+			else
+			{
+				replay.tunings.push_back({ tick, tuning });
+			}
+		}
+
+		replay.inputs.push_back(input);
+	}
+
+	void Truncate(Replay& replay, uint64_t tick)
+	{
+		if (tick < replay.inputs.size())
+		{
+			replay.inputs.resize(static_cast<size_t>(tick));
+		}
+
+		// The first change stays; it is what the round started with
+		while (replay.tunings.size() > 1 && replay.tunings.back().tick >= tick)
+		{
+			replay.tunings.pop_back();
+		}
+	}
+
+	void Finish(Replay& replay, const World::World& world)
+	{
+		replay.finalHash = StateHash::Hash(world);
+	}
+
+	void Restart(const Replay& replay, World::World& world)
+	{
+		Tuning::Set(replay.tunings.front().tuning);
+
+		World::Reset(world, replay.playerCount, replay.seed);
+		world.deltaT = replay.deltaT;
+	}
+
+	void ApplyTuning(const Replay& replay, uint64_t tick)
+	{
+		auto change = std::lower_bound(replay.tunings.begin(), replay.tunings.end(), tick, [](const TuningChange& change, uint64_t tick)
+		{
+			return change.tick < tick;
+		});
+
+		if (change != replay.tunings.end() && change->tick == tick)
+		{
+			Tuning::Set(change->tuning);
+		}
+	}
+
+	bool Save(const Replay& replay, const std::string& path)
+	{
+		std::ofstream file(path);
+
+		if (!file)
+		{
+			return false;
+		}
+
+		// Delta time as its bit pattern, a rounded decimal would play back a different game
+		uint32_t deltaBits;
+		std::memcpy(&deltaBits, &replay.deltaT, sizeof(deltaBits));
+
+		file << Variables::fileHeader << " " << Variables::fileVersion << "\n";
+		file << std::hex << replay.seed << " " << replay.playerCount << " " << deltaBits << " " << replay.finalHash << " " << replay.inputs.size() << " " << replay.tunings.size() << "\n";
+
+		// One line per tuning change: its tick, then the tuning's words
+		for (const TuningChange& change : replay.tunings)
+		{
+			uint32_t words[Variables::tuningWords];
+			std::memcpy(words, &change.tuning, sizeof(words));
+
+			file << change.tick;
+
+			for (uint32_t word : words)
+			{
+				file << " " << word;
+			}
+
+			file << "\n";
+		}
+
+		// Runs of equal inputs, one per line; most ticks nobody flaps
+		size_t start = 0;
+
+		while (start < replay.inputs.size())
+		{
+			size_t end = start + 1;
+
+			while (end < replay.inputs.size() && replay.inputs[end] == replay.inputs[start])
+			{
+				end++;
+			}
+
+			file << end - start << " " << static_cast<int>(replay.inputs[start]) << "\n";
+			start = end;
+		}
+
+		return static_cast<bool>(file);
+	}
+
+	bool Load(Replay& replay, const std::string& path)
+	{
+		std::ifstream file(path);
+
+		std::string header;
+		int version = 0;
+
+		// Version 1 predates tuning; those rounds were played with the defaults
+		if (!(file >> header >> version) || header != Variables::fileHeader || version < 1 || version > Variables::fileVersion)
+		{
+			return false;
+		}
+
+		Replay loaded;
+		uint32_t deltaBits = 0;
+		size_t tickCount = 0;
+		size_t tuningCount = 1;
+
+		if (!(file >> std::hex >> loaded.seed >> loaded.playerCount >> deltaBits >> loaded.finalHash >> tickCount) || loaded.playerCount < 1 || loaded.playerCount > World::maxPlayers)
+		{
+			return false;
+		}
+
+		// Before version 3 the hash left out the difficulty, so there is nothing to check the end against
+		if (version < 3)
+		{
+			loaded.finalHash = 0;
+		}
+
+		if (version >= 2 && (!(file >> tuningCount) || tuningCount < 1 || tuningCount > tickCount + 1))
+		{
+			return false;
+		}
+
+		loaded.tunings.assign(1, { 0, Tuning::Tuning() });
+
+		for (size_t i = 0; i < tuningCount && version >= 2; i++)
+		{
+			TuningChange change;
+			uint32_t words[Variables::tuningWords];
+
+			if (!(file >> change.tick))
+			{
+				return false;
+			}
+
+			for (uint32_t& word : words)
+			{
+				if (!(file >> word))
+				{
+					return false;
+				}
+			}
+
+			std::memcpy(&change.tuning, words, sizeof(words));
+
+			// In tick order, starting at tick 0
+			bool isInOrder = i == 0 ? change.tick == 0 : change.tick > loaded.tunings.back().tick && change.tick < tickCount;
+
+			if (!isInOrder || !Tuning::IsValid(change.tuning))
+			{
+				return false;
+			}
+
+			if (i == 0)
+			{
+				loaded.tunings[0] = change;
+			}
+			else
+			{
+				loaded.tunings.push_back(change);
+			}
+		}
+
+		std::memcpy(&loaded.deltaT, &deltaBits, sizeof(deltaBits));
+
+		if (!(loaded.deltaT > 0.0f))
+		{
+			return false;
+		}
+
+		loaded.inputs.reserve(tickCount);
+
+		while (loaded.inputs.size() < tickCount)
+		{
+			size_t run = 0;
+			int input = 0;
+
+			if (!(file >> run >> input) || run == 0 || run > tickCount - loaded.inputs.size())
+			{
+				return false;
+			}
+
+			loaded.inputs.insert(loaded.inputs.end(), run, static_cast<World::Input>(input));
+		}
+
+		replay = loaded;
+		return true;
+	}
+}
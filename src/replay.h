@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tuning.h"
+#include "world.h"
+
+// A round kept as its seed, the tuning it was played with and the input of every tick; the world is deterministic, so
+// that is enough to play it again
+namespace Replay
+{
+	// In effect from tick on, until the next change
+	struct TuningChange
+	{
+		uint64_t tick;
+		Tuning::Tuning tuning;
+	};
+
+	struct Replay
+	{
+		uint64_t seed;
+		int playerCount;
+		float deltaT;
+
+		std::vector<World::Input> inputs;
+
+		// The first is at tick 0; the difficulty schedule lives in the tuning, so this is every difficulty change too
+		std::vector<TuningChange> tunings;
+
+		// State hash after the last input, so a replay that no longer plays back the same is caught
+		uint64_t finalHash;
+	};
+
+	// Call right after the world is reset
+	void Begin(Replay& replay, const World::World& world);
+	// Also notes the tuning if it changed since the last tick, so reloads mid round play back
+	void Record(Replay& replay, World::Input input);
+
+	// Forgets the inputs and tuning changes past tick, for when the world was rewound
+	void Truncate(Replay& replay, uint64_t tick);
+	void Finish(Replay& replay, const World::World& world);
+
+	// Resets world and the tuning to where the replay starts
+	void Restart(const Replay& replay, World::World& world);
+	// Sets the tuning recorded for the tick about to be stepped, if it changed there
+	void ApplyTuning(const Replay& replay, uint64_t tick);
+
+	bool Save(const Replay& replay, const std::string& path);
+	bool Load(Replay& replay, const std::string& path);
+}
@@ -0,0 +1,114 @@
+#include "rng.h"
+
+#include <ctime>
+#include <random>
+
+namespace Rng
+{
+	namespace Variables
+	{
+		const uint64_t multiplier = 6364136223846793005ULL;
+		const int64_t secondsPerDay = 86400;
+	}
+
+	static uint64_t SplitMix(uint64_t value);
+
+	uint64_t SplitMix(uint64_t value)
+	{
+		value += 0x9E3779B97F4A7C15ULL;
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+		return value ^ (value >> 31);
+	}
+
+	void Seed(Rng& rng, uint64_t seed, uint64_t stream)
+	{
+		rng.state = 0;
+		rng.increment = (SplitMix(stream) << 1) | 1;
+
+		Next(rng);
+		rng.state += SplitMix(seed);
+		Next(rng);
+	}
+
+	uint32_t Next(Rng& rng)
+	{
+		uint64_t oldState = rng.state;
+		rng.state = oldState * Variables::multiplier + rng.increment;
+
+		uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18) ^ oldState) >> 27);
+		uint32_t rotation = static_cast<uint32_t>(oldState >> 59);
+
+		return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31));
+	}
+
+	int Range(Rng& rng, int min, int max)
+	{
+		if (max <= min)
+		{
+			return min;
+		}
+
+		uint32_t bound = static_cast<uint32_t>(static_cast<int64_t>(max) - min + 1);
+
+		// Reject the low sliver that would bias the modulo
+		uint32_t threshold = (0u - bound) % bound;
+
+		uint32_t value = Next(rng);
+
+		while (value < threshold)
+		{
+			value = Next(rng);
+		}
+
+		return static_cast<int>(static_cast<int64_t>(min) + value % bound);
+	}
+
+	float Float(Rng& rng)
+	{
+		return static_cast<float>(Next(rng) >> 8) * (1.0f / 16777216.0f);
+	}
+
+	void Advance(Rng& rng, uint64_t delta)
+	{
+		uint64_t accumulatedMultiplier = 1;
+		uint64_t accumulatedIncrement = 0;
+
+		uint64_t currentMultiplier = Variables::multiplier;
+		uint64_t currentIncrement = rng.increment;
+
+		while (delta > 0)
+		{
+			if (delta & 1)
+			{
+				accumulatedMultiplier *= currentMultiplier;
+				accumulatedIncrement = accumulatedIncrement * currentMultiplier + currentIncrement;
+			}
+
+			currentIncrement = (currentMultiplier + 1) * currentIncrement;
+			currentMultiplier *= currentMultiplier;
+			delta >>= 1;
+		}
+
+		rng.state = accumulatedMultiplier * rng.state + accumulatedIncrement;
+	}
+
+	uint64_t RandomSeed()
+	{
+		std::random_device device;
+
+		uint64_t seed = (static_cast<uint64_t>(device()) << 32) | device();
+
+		return SplitMix(seed ^ static_cast<uint64_t>(std::time(nullptr)));
+	}
+
+	uint64_t DailySeed()
+	{
+		return DailySeed(static_cast<int64_t>(std::time(nullptr)) / Variables::secondsPerDay);
+	}
+
+	uint64_t DailySeed(int64_t daysSinceEpoch)
+	{
+		return SplitMix(static_cast<uint64_t>(daysSinceEpoch));
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+namespace Rng
+{
+	// PCG32 (XSH RR): 64 bit LCG state, one of 2^63 streams picked by the increment
+	struct Rng
+	{
+		uint64_t state;
+		uint64_t increment;
+	};
+
+	void Seed(Rng& rng, uint64_t seed, uint64_t stream = 0);
+
+	uint32_t Next(Rng& rng);
+	int Range(Rng& rng, int min, int max);
+	float Float(Rng& rng);
+
+	// Jumps delta draws ahead (or behind, with a wrapped negative delta) in O(log delta)
+	void Advance(Rng& rng, uint64_t delta);
+
+	uint64_t RandomSeed();
+	uint64_t DailySeed();
+	uint64_t DailySeed(int64_t daysSinceEpoch);
+}
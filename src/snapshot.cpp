@@ -0,0 +1,131 @@
+#include "snapshot.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace Snapshot
+{
+	static_assert(std::is_trivially_copyable<Snapshot>::value, "Snapshot must stay plain data");
+
+	static void CaptureBird(const Player::Bird& bird, Bird& snapshot);
+	static void RestoreBird(Player::Bird& bird, const Bird& snapshot);
+	static bool IsBirdEqual(const Bird& a, const Bird& b);
+
+	void CaptureBird(const Player::Bird& bird, Bird& snapshot)
+	{
+		snapshot.position = bird.position;
+		snapshot.velocity = bird.velocity;
+		snapshot.isOn = bird.isOn;
+	}
+
+	void RestoreBird(Player::Bird& bird, const Bird& snapshot)
+	{
+		bird.position = snapshot.position;
+		bird.velocity = snapshot.velocity;
+		bird.isOn = snapshot.isOn;
+	}
+
+	bool IsBirdEqual(const Bird& a, const Bird& b)
+	{
+		return a.position.x == b.position.x && a.position.y == b.position.y && a.velocity == b.velocity && a.isOn == b.isOn;
+	}
+
+	void Capture(const World::World& world, Snapshot& snapshot)
+	{
+		for (int i = 0; i < World::maxPlayers; i++)
+		{
+			CaptureBird(world.birds[i], snapshot.birds[i]);
+			snapshot.scores[i] = world.scores[i];
+		}
+
+		snapshot.obstacleBottom = world.obstacle.bottom;
+		snapshot.obstacleTop = world.obstacle.top;
+		snapshot.obstaclePassed = world.obstacle.passed;
+		snapshot.obstacleVelocity = world.obstacle.velocity;
+		snapshot.difficulty = world.difficulty;
+
+		snapshot.rng = world.rng;
+
+		snapshot.tick = world.tick;
+		snapshot.score = world.score;
+		snapshot.timeAlive = world.timeAlive;
+		snapshot.hasLost = world.hasLost;
+	}
+
+	void Restore(World::World& world, const Snapshot& snapshot)
+	{
+		for (int i = 0; i < World::maxPlayers; i++)
+		{
+			RestoreBird(world.birds[i], snapshot.birds[i]);
+			world.scores[i] = snapshot.scores[i];
+		}
+
+		world.obstacle.bottom = snapshot.obstacleBottom;
+		world.obstacle.top = snapshot.obstacleTop;
+		world.obstacle.passed = snapshot.obstaclePassed;
+		world.obstacle.velocity = snapshot.obstacleVelocity;
+		world.difficulty = snapshot.difficulty;
+
+		world.rng = snapshot.rng;
+
+		world.tick = snapshot.tick;
+		world.score = snapshot.score;
+		world.timeAlive = snapshot.timeAlive;
+		world.hasLost = snapshot.hasLost;
+
+		world.events = 0;
+		world.hits = 0;
+	}
+
+	bool IsEqual(const Snapshot& a, const Snapshot& b)
+	{
+		for (int i = 0; i < World::maxPlayers; i++)
+		{
+			if (!IsBirdEqual(a.birds[i], b.birds[i]) || a.scores[i] != b.scores[i])
+			{
+				return false;
+			}
+		}
+
+		return a.obstacleBottom.x == b.obstacleBottom.x && a.obstacleBottom.y == b.obstacleBottom.y
+			&& a.obstacleTop.x == b.obstacleTop.x && a.obstacleTop.y == b.obstacleTop.y
+			&& a.obstaclePassed == b.obstaclePassed && a.obstacleVelocity == b.obstacleVelocity
+			&& a.difficulty.levels.obstacleVelocity == b.difficulty.levels.obstacleVelocity && a.difficulty.levels.gapSpace == b.difficulty.levels.gapSpace
+			&& a.difficulty.levels.obstacleSpacing == b.difficulty.levels.obstacleSpacing
+			&& a.difficulty.segments[0] == b.difficulty.segments[0] && a.difficulty.segments[1] == b.difficulty.segments[1]
+			&& a.difficulty.segments[2] == b.difficulty.segments[2]
+			&& a.rng.state == b.rng.state && a.rng.increment == b.rng.increment
+			&& a.tick == b.tick && a.score == b.score && a.timeAlive == b.timeAlive && a.hasLost == b.hasLost;
+	}
+
+	void Clear(RewindBuffer& buffer)
+	{
+		buffer.newest = -1;
+		buffer.count = 0;
+	}
+
+	void Push(RewindBuffer& buffer, const World::World& world)
+	{
+		buffer.newest = (buffer.newest + 1) % rewindCapacity;
+		buffer.count = std::min(buffer.count + 1, rewindCapacity);
+
+		Capture(world, buffer.snapshots[buffer.newest]);
+	}
+
+	int Rewind(RewindBuffer& buffer, World::World& world, int ticks)
+	{
+		if (buffer.count == 0)
+		{
+			return 0;
+		}
+
+		ticks = std::max(0, std::min(ticks, buffer.count - 1));
+
+		buffer.newest = (buffer.newest - ticks + rewindCapacity) % rewindCapacity;
+		buffer.count -= ticks;
+
+		Restore(world, buffer.snapshots[buffer.newest]);
+
+		return ticks;
+	}
+}
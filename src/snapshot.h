@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+
+#include "world.h"
+
+namespace Snapshot
+{
+	struct Bird
+	{
+		Vector2 position;
+		float velocity;
+		bool isOn;
+	};
+
+	// Only the state World::Update changes; seed, player count and sizes stay in the world being restored
+	struct Snapshot
+	{
+		Bird birds[World::maxPlayers];
+		int scores[World::maxPlayers];
+
+		Vector2 obstacleBottom;
+		Vector2 obstacleTop;
+		uint8_t obstaclePassed;
+		float obstacleVelocity;
+
+		Difficulty::State difficulty;
+
+		Rng::Rng rng;
+
+		uint64_t tick;
+		int score;
+		float timeAlive;
+		bool hasLost;
+	};
+
+	void Capture(const World::World& world, Snapshot& snapshot);
+	void Restore(World::World& world, const Snapshot& snapshot);
+
+	// Field by field, so padding bytes never count as a difference
+	bool IsEqual(const Snapshot& a, const Snapshot& b);
+
+	// 1024 ticks is about 8.5 seconds at the default 120 Hz
+	const int rewindCapacity = 1024;
+
+	struct RewindBuffer
+	{
+		Snapshot snapshots[rewindCapacity];
+
+		int newest;
+		int count;
+	};
+
+	void Clear(RewindBuffer& buffer);
+	void Push(RewindBuffer& buffer, const World::World& world);
+
+	// Restores the state from up to ticks ago and forgets everything newer; the oldest snapshot is always kept
+	int Rewind(RewindBuffer& buffer, World::World& world, int ticks);
+}
@@ -0,0 +1,588 @@
+#include "soft_render.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+#include "job_system.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define SOFT_RENDER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace SoftRender
+{
+	namespace Font
+	{
+		const int firstChar = 32;
+		const int charCount = 95;
+		const int glyphWidth = 5;
+		const int glyphHeight = 8;
+		const int advance = glyphWidth + 1;
+
+		// Classic 5x7 LCD font, one byte per column, bit 0 is the top row
+		static const uint8_t glyphs[charCount][glyphWidth] =
+		{
+			{ 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5F, 0x00, 0x00 }, { 0x00, 0x07, 0x00, 0x07, 0x00 }, { 0x14, 0x7F, 0x14, 0x7F, 0x14 },
+			{ 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 }, { 0x36, 0x49, 0x56, 0x20, 0x50 }, { 0x00, 0x08, 0x07, 0x03, 0x00 },
+			{ 0x00, 0x1C, 0x22, 0x41, 0x00 }, { 0x00, 0x41, 0x22, 0x1C, 0x00 }, { 0x2A, 0x1C, 0x7F, 0x1C, 0x2A }, { 0x08, 0x08, 0x3E, 0x08, 0x08 },
+			{ 0x00, 0x80, 0x70, 0x30, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, { 0x00, 0x00, 0x60, 0x60, 0x00 }, { 0x20, 0x10, 0x08, 0x04, 0x02 },
+			{ 0x3E, 0x51, 0x49, 0x45, 0x3E }, { 0x00, 0x42, 0x7F, 0x40, 0x00 }, { 0x72, 0x49, 0x49, 0x49, 0x46 }, { 0x21, 0x41, 0x49, 0x4D, 0x33 },
+			{ 0x18, 0x14, 0x12, 0x7F, 0x10 }, { 0x27, 0x45, 0x45, 0x45, 0x39 }, { 0x3C, 0x4A, 0x49, 0x49, 0x31 }, { 0x41, 0x21, 0x11, 0x09, 0x07 },
+			{ 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x46, 0x49, 0x49, 0x29, 0x1E }, { 0x00, 0x00, 0x14, 0x00, 0x00 }, { 0x00, 0x40, 0x34, 0x00, 0x00 },
+			{ 0x00, 0x08, 0x14, 0x22, 0x41 }, { 0x14, 0x14, 0x14, 0x14, 0x14 }, { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x59, 0x09, 0x06 },
+			{ 0x3E, 0x41, 0x5D, 0x59, 0x4E }, { 0x7C, 0x12, 0x11, 0x12, 0x7C }, { 0x7F, 0x49, 0x49, 0x49, 0x36 }, { 0x3E, 0x41, 0x41, 0x41, 0x22 },
+			{ 0x7F, 0x41, 0x41, 0x41, 0x3E }, { 0x7F, 0x49, 0x49, 0x49, 0x41 }, { 0x7F, 0x09, 0x09, 0x09, 0x01 }, { 0x3E, 0x41, 0x41, 0x51, 0x73 },
+			{ 0x7F, 0x08, 0x08, 0x08, 0x7F }, { 0x00, 0x41, 0x7F, 0x41, 0x00 }, { 0x20, 0x40, 0x41, 0x3F, 0x01 }, { 0x7F, 0x08, 0x14, 0x22, 0x41 },
+			{ 0x7F, 0x40, 0x40, 0x40, 0x40 }, { 0x7F, 0x02, 0x1C, 0x02, 0x7F }, { 0x7F, 0x04, 0x08, 0x10, 0x7F }, { 0x3E, 0x41, 0x41, 0x41, 0x3E },
+			{ 0x7F, 0x09, 0x09, 0x09, 0x06 }, { 0x3E, 0x41, 0x51, 0x21, 0x5E }, { 0x7F, 0x09, 0x19, 0x29, 0x46 }, { 0x26, 0x49, 0x49, 0x49, 0x32 },
+			{ 0x03, 0x01, 0x7F, 0x01, 0x03 }, { 0x3F, 0x40, 0x40, 0x40, 0x3F }, { 0x1F, 0x20, 0x40, 0x20, 0x1F }, { 0x3F, 0x40, 0x38, 0x40, 0x3F },
+			{ 0x63, 0x14, 0x08, 0x14, 0x63 }, { 0x03, 0x04, 0x78, 0x04, 0x03 }, { 0x61, 0x59, 0x49, 0x4D, 0x43 }, { 0x00, 0x7F, 0x41, 0x41, 0x41 },
+			{ 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x41, 0x7F }, { 0x04, 0x02, 0x01, 0x02, 0x04 }, { 0x40, 0x40, 0x40, 0x40, 0x40 },
+			{ 0x00, 0x03, 0x07, 0x08, 0x00 }, { 0x20, 0x54, 0x54, 0x78, 0x40 }, { 0x7F, 0x28, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x28 },
+			{ 0x38, 0x44, 0x44, 0x28, 0x7F }, { 0x38, 0x54, 0x54, 0x54, 0x18 }, { 0x00, 0x08, 0x7E, 0x09, 0x02 }, { 0x18, 0xA4, 0xA4, 0x9C, 0x78 },
+			{ 0x7F, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7D, 0x40, 0x00 }, { 0x20, 0x40, 0x40, 0x3D, 0x00 }, { 0x7F, 0x10, 0x28, 0x44, 0x00 },
+			{ 0x00, 0x41, 0x7F, 0x40, 0x00 }, { 0x7C, 0x04, 0x78, 0x04, 0x78 }, { 0x7C, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 },
+			{ 0xFC, 0x18, 0x24, 0x24, 0x18 }, { 0x18, 0x24, 0x24, 0x18, 0xFC }, { 0x7C, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x24 },
+			{ 0x04, 0x04, 0x3F, 0x44, 0x24 }, { 0x3C, 0x40, 0x40, 0x20, 0x7C }, { 0x1C, 0x20, 0x40, 0x20, 0x1C }, { 0x3C, 0x40, 0x30, 0x40, 0x3C },
+			{ 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x4C, 0x90, 0x90, 0x90, 0x7C }, { 0x44, 0x64, 0x54, 0x4C, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 },
+			{ 0x00, 0x00, 0x77, 0x00, 0x00 }, { 0x00, 0x41, 0x36, 0x08, 0x00 }, { 0x02, 0x01, 0x02, 0x04, 0x02 }
+		};
+
+		static int GetPixelSize(int fontSize);
+	}
+
+	struct Tile
+	{
+		int x0;
+		int y0;
+		int x1;
+		int y1;
+	};
+
+	static uint32_t Pack(Color color);
+	static uint32_t Tint(uint32_t pixel, Color tint);
+
+	static void FillSpan(uint32_t* pixels, int count, Color color);
+	static void BlendSpan(uint32_t* pixels, int count, Color color);
+	static void BlendPixels(uint32_t* pixels, const uint32_t* source, int count);
+
+	static void RasterizeRectangle(Framebuffer& framebuffer, const Tile& tile, int x0, int y0, int x1, int y1, Color color);
+	static void RasterizeCircle(Framebuffer& framebuffer, const Tile& tile, const Command& command);
+	static void RasterizeImage(Framebuffer& framebuffer, const Tile& tile, const Command& command, std::vector<uint32_t>& row);
+	static void RasterizeText(Framebuffer& framebuffer, const Tile& tile, const Command& command);
+	static void RasterizeTile(const Frame& frame, Framebuffer& framebuffer, const Tile& tile, std::vector<uint32_t>& row);
+
+	int Font::GetPixelSize(int fontSize)
+	{
+		return std::max(1, fontSize / 10);
+	}
+
+	uint32_t Pack(Color color)
+	{
+		return static_cast<uint32_t>(color.r) | (static_cast<uint32_t>(color.g) << 8) | (static_cast<uint32_t>(color.b) << 16) | (static_cast<uint32_t>(color.a) << 24);
+	}
+
+	uint32_t Tint(uint32_t pixel, Color tint)
+	{
+		uint32_t r = ((pixel & 0xFF) * tint.r + 127) / 255;
+		uint32_t g = (((pixel >> 8) & 0xFF) * tint.g + 127) / 255;
+		uint32_t b = (((pixel >> 16) & 0xFF) * tint.b + 127) / 255;
+		uint32_t a = ((pixel >> 24) * tint.a + 127) / 255;
+
+		return r | (g << 8) | (b << 16) | (a << 24);
+	}
+
+	void FillSpan(uint32_t* pixels, int count, Color color)
+	{
+		std::fill(pixels, pixels + count, Pack(color));
+	}
+
+	// out = (source * a + destination * (255 - a)) / 255, rounded; alpha is composited as if the source alpha were 255.
+	// The SIMD and scalar paths do the same integer math, so images match bit for bit on any machine
+	void BlendSpan(uint32_t* pixels, int count, Color color)
+	{
+		const uint32_t alpha = color.a;
+		const uint32_t inverse = 255 - alpha;
+		const uint32_t source[4] = { color.r * alpha, color.g * alpha, color.b * alpha, 255 * alpha };
+
+		int i = 0;
+
+#if SOFT_RENDER_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i inverse16 = _mm_set1_epi16(static_cast<short>(inverse));
+		const __m128i source16 = _mm_setr_epi16(static_cast<short>(source[0]), static_cast<short>(source[1]), static_cast<short>(source[2]), static_cast<short>(source[3]),
+			static_cast<short>(source[0]), static_cast<short>(source[1]), static_cast<short>(source[2]), static_cast<short>(source[3]));
+		const __m128i half = _mm_set1_epi16(128);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i destination = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+
+			__m128i low = _mm_add_epi16(_mm_add_epi16(source16, _mm_mullo_epi16(_mm_unpacklo_epi8(destination, zero), inverse16)), half);
+			__m128i high = _mm_add_epi16(_mm_add_epi16(source16, _mm_mullo_epi16(_mm_unpackhi_epi8(destination, zero), inverse16)), half);
+
+			low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+			high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), _mm_packus_epi16(low, high));
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			uint32_t pixel = pixels[i];
+			uint32_t result = 0;
+
+			for (int channel = 0; channel < 4; channel++)
+			{
+				uint32_t value = source[channel] + ((pixel >> (8 * channel)) & 0xFF) * inverse + 128;
+				result |= ((value + (value >> 8)) >> 8) << (8 * channel);
+			}
+
+			pixels[i] = result;
+		}
+	}
+
+	void BlendPixels(uint32_t* pixels, const uint32_t* source, int count)
+	{
+		int i = 0;
+
+#if SOFT_RENDER_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi16(255);
+		const __m128i opaque = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+		const __m128i half = _mm_set1_epi16(128);
+		const __m128i alphaBits = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i sourcePixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			int alphaMask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(sourcePixels, alphaBits), alphaBits));
+			int clearMask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(sourcePixels, alphaBits), zero));
+
+			// Sprites are mostly fully opaque or fully clear, both come out of the blend unchanged
+			if (alphaMask == 0xFFFF)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), sourcePixels);
+				continue;
+			}
+
+			if (clearMask == 0xFFFF)
+			{
+				continue;
+			}
+
+			__m128i destination = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+
+			__m128i halves[2] = { _mm_unpacklo_epi8(sourcePixels, zero), _mm_unpackhi_epi8(sourcePixels, zero) };
+			__m128i destinations[2] = { _mm_unpacklo_epi8(destination, zero), _mm_unpackhi_epi8(destination, zero) };
+
+			for (int j = 0; j < 2; j++)
+			{
+				__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[j], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+				__m128i value = _mm_add_epi16(_mm_mullo_epi16(_mm_or_si128(halves[j], opaque), alpha), _mm_mullo_epi16(destinations[j], _mm_sub_epi16(full, alpha)));
+
+				value = _mm_add_epi16(value, half);
+				halves[j] = _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), _mm_packus_epi16(halves[0], halves[1]));
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			uint32_t pixel = pixels[i];
+			uint32_t sourcePixel = source[i] | 0xFF000000u;
+			uint32_t alpha = source[i] >> 24;
+			uint32_t result = 0;
+
+			for (int channel = 0; channel < 4; channel++)
+			{
+				uint32_t value = ((sourcePixel >> (8 * channel)) & 0xFF) * alpha + ((pixel >> (8 * channel)) & 0xFF) * (255 - alpha) + 128;
+				result |= ((value + (value >> 8)) >> 8) << (8 * channel);
+			}
+
+			pixels[i] = result;
+		}
+	}
+
+	void Begin(Frame& frame, int width, int height, Color clear)
+	{
+		frame.width = width;
+		frame.height = height;
+		frame.clear = clear;
+		frame.scale = { 1.0f, 1.0f };
+		frame.commands.clear();
+	}
+
+	void SetScale(Frame& frame, float x, float y)
+	{
+		frame.scale = { x, y };
+	}
+
+	void FillRectangle(Frame& frame, int x, int y, int width, int height, Color color)
+	{
+		// Edges are rounded on their own so neighbouring rectangles still meet when scaled
+		float x0 = std::round(x * frame.scale.x);
+		float y0 = std::round(y * frame.scale.y);
+		float x1 = std::round((x + width) * frame.scale.x);
+		float y1 = std::round((y + height) * frame.scale.y);
+
+		Command command = { CommandType::Rectangle, x0, y0, x1 - x0, y1 - y0, color, nullptr, std::string() };
+		frame.commands.push_back(command);
+	}
+
+	void FillCircle(Frame& frame, Vector2 center, float radius, Color color)
+	{
+		float scaledRadius = radius * (frame.scale.x + frame.scale.y) * 0.5f;
+
+		Command command = { CommandType::Circle, center.x * frame.scale.x, center.y * frame.scale.y, scaledRadius, scaledRadius, color, nullptr, std::string() };
+		frame.commands.push_back(command);
+	}
+
+	void DrawImage(Frame& frame, const Image& image, float x, float y, float width, float height, Color tint)
+	{
+		Command command = { CommandType::Image, x * frame.scale.x, y * frame.scale.y, width * frame.scale.x, height * frame.scale.y, tint, &image, std::string() };
+		frame.commands.push_back(command);
+	}
+
+	void DrawString(Frame& frame, const std::string& text, int x, int y, int fontSize, Color color)
+	{
+		float pixelSize = std::max(1.0f, std::round(Font::GetPixelSize(fontSize) * frame.scale.y));
+
+		Command command = { CommandType::Text, std::round(x * frame.scale.x), std::round(y * frame.scale.y), pixelSize, 0.0f, color, nullptr, text };
+		frame.commands.push_back(command);
+	}
+
+	int MeasureString(const std::string& text, int fontSize)
+	{
+		if (text.empty())
+		{
+			return 0;
+		}
+
+		return (static_cast<int>(text.size()) * Font::advance - 1) * Font::GetPixelSize(fontSize);
+	}
+
+	void RasterizeRectangle(Framebuffer& framebuffer, const Tile& tile, int x0, int y0, int x1, int y1, Color color)
+	{
+		x0 = std::max(x0, tile.x0);
+		y0 = std::max(y0, tile.y0);
+		x1 = std::min(x1, tile.x1);
+		y1 = std::min(y1, tile.y1);
+
+		if (x0 >= x1 || y0 >= y1 || color.a == 0)
+		{
+			return;
+		}
+
+		for (int y = y0; y < y1; y++)
+		{
+			uint32_t* row = framebuffer.pixels.data() + static_cast<size_t>(y) * framebuffer.width + x0;
+
+			if (color.a == 255)
+			{
+				FillSpan(row, x1 - x0, color);
+			}
+			else
+			{
+				BlendSpan(row, x1 - x0, color);
+			}
+		}
+	}
+
+	void RasterizeCircle(Framebuffer& framebuffer, const Tile& tile, const Command& command)
+	{
+		float radius = command.width;
+
+		int y0 = std::max(tile.y0, static_cast<int>(std::floor(command.y - radius)));
+		int y1 = std::min(tile.y1, static_cast<int>(std::ceil(command.y + radius)) + 1);
+
+		// A pixel is in when its center is, one span per row
+		for (int y = y0; y < y1; y++)
+		{
+			float dy = y + 0.5f - command.y;
+			float squared = radius * radius - dy * dy;
+
+			if (squared < 0.0f)
+			{
+				continue;
+			}
+
+			float half = std::sqrt(squared);
+			int x0 = static_cast<int>(std::ceil(command.x - half - 0.5f));
+			int x1 = static_cast<int>(std::floor(command.x + half - 0.5f)) + 1;
+
+			RasterizeRectangle(framebuffer, tile, x0, y, x1, y + 1, command.color);
+		}
+	}
+
+	void RasterizeImage(Framebuffer& framebuffer, const Tile& tile, const Command& command, std::vector<uint32_t>& row)
+	{
+		const Image& image = *command.image;
+
+		if (image.width <= 0 || image.height <= 0 || command.width <= 0.0f || command.height <= 0.0f)
+		{
+			return;
+		}
+
+		int x0 = std::max(tile.x0, static_cast<int>(std::ceil(command.x - 0.5f)));
+		int x1 = std::min(tile.x1, static_cast<int>(std::ceil(command.x + command.width - 0.5f)));
+		int y0 = std::max(tile.y0, static_cast<int>(std::ceil(command.y - 0.5f)));
+		int y1 = std::min(tile.y1, static_cast<int>(std::ceil(command.y + command.height - 0.5f)));
+
+		if (x0 >= x1 || y0 >= y1)
+		{
+			return;
+		}
+
+		float scaleX = image.width / command.width;
+		float scaleY = image.height / command.height;
+
+		bool isTinted = command.color.r != 255 || command.color.g != 255 || command.color.b != 255 || command.color.a != 255;
+
+		const int width = x1 - x0;
+
+		// Source columns are the same on every row, the row buffer holds them past the pixels
+		row.resize(static_cast<size_t>(width) * 2);
+		uint32_t* columns = row.data() + width;
+
+		for (int x = x0; x < x1; x++)
+		{
+			columns[x - x0] = static_cast<uint32_t>(std::min(image.width - 1, static_cast<int>((x + 0.5f - command.x) * scaleX)));
+		}
+
+		for (int y = y0; y < y1; y++)
+		{
+			int v = std::min(image.height - 1, static_cast<int>((y + 0.5f - command.y) * scaleY));
+			const uint32_t* source = image.pixels.data() + static_cast<size_t>(v) * image.width;
+
+			for (int x = 0; x < width; x++)
+			{
+				row[x] = isTinted ? Tint(source[columns[x]], command.color) : source[columns[x]];
+			}
+
+			BlendPixels(framebuffer.pixels.data() + static_cast<size_t>(y) * framebuffer.width + x0, row.data(), width);
+		}
+	}
+
+	void RasterizeText(Framebuffer& framebuffer, const Tile& tile, const Command& command)
+	{
+		int pixelSize = static_cast<int>(command.width);
+		int originX = static_cast<int>(command.x);
+		int originY = static_cast<int>(command.y);
+
+		if (originY >= tile.y1 || originY + Font::glyphHeight * pixelSize <= tile.y0)
+		{
+			return;
+		}
+
+		for (size_t i = 0; i < command.text.size(); i++)
+		{
+			int glyphX = originX + static_cast<int>(i) * Font::advance * pixelSize;
+
+			if (glyphX >= tile.x1)
+			{
+				break;
+			}
+
+			int character = static_cast<unsigned char>(command.text[i]) - Font::firstChar;
+
+			if (glyphX + Font::glyphWidth * pixelSize <= tile.x0 || character < 0 || character >= Font::charCount)
+			{
+				continue;
+			}
+
+			for (int column = 0; column < Font::glyphWidth; column++)
+			{
+				uint8_t bits = Font::glyphs[character][column];
+
+				for (int rowIndex = 0; bits != 0; rowIndex++, bits >>= 1)
+				{
+					if (bits & 1)
+					{
+						int x = glyphX + column * pixelSize;
+						int y = originY + rowIndex * pixelSize;
+
+						RasterizeRectangle(framebuffer, tile, x, y, x + pixelSize, y + pixelSize, command.color);
+					}
+				}
+			}
+		}
+	}
+
+	void RasterizeTile(const Frame& frame, Framebuffer& framebuffer, const Tile& tile, std::vector<uint32_t>& row)
+	{
+		for (int y = tile.y0; y < tile.y1; y++)
+		{
+			FillSpan(framebuffer.pixels.data() + static_cast<size_t>(y) * framebuffer.width + tile.x0, tile.x1 - tile.x0, frame.clear);
+		}
+
+		for (const Command& command : frame.commands)
+		{
+			switch (command.type)
+			{
+			case CommandType::Rectangle:
+				RasterizeRectangle(framebuffer, tile, static_cast<int>(command.x), static_cast<int>(command.y), static_cast<int>(command.x + command.width), static_cast<int>(command.y + command.height), command.color);
+				break;
+
+			case CommandType::Circle:
+				if (command.x + command.width >= tile.x0 && command.x - command.width <= tile.x1)
+				{
+					RasterizeCircle(framebuffer, tile, command);
+				}
+				break;
+
+			case CommandType::Image:
+				RasterizeImage(framebuffer, tile, command, row);
+				break;
+
+			case CommandType::Text:
+				RasterizeText(framebuffer, tile, command);
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+
+	void Render(const Frame& frame, Framebuffer& framebuffer, int tileSize)
+	{
+		framebuffer.width = frame.width;
+		framebuffer.height = frame.height;
+		framebuffer.pixels.resize(static_cast<size_t>(frame.width) * frame.height);
+
+		tileSize = std::max(tileSize, 8);
+
+		const int tilesX = (frame.width + tileSize - 1) / tileSize;
+		const int tilesY = (frame.height + tileSize - 1) / tileSize;
+
+		// Tiles never share pixels, so workers need no synchronization; each keeps its own scratch row
+		std::vector<std::vector<uint32_t>> rows(Jobs::GetThreadCount());
+
+		Jobs::ParallelFor(tilesX * tilesY, 1, [&](int begin, int end, int worker)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				Tile tile;
+				tile.x0 = (i % tilesX) * tileSize;
+				tile.y0 = (i / tilesX) * tileSize;
+				tile.x1 = std::min(tile.x0 + tileSize, frame.width);
+				tile.y1 = std::min(tile.y0 + tileSize, frame.height);
+
+				RasterizeTile(frame, framebuffer, tile, rows[worker]);
+			}
+		});
+	}
+
+	Image FromRgba(int width, int height, const uint8_t* rgba)
+	{
+		Image image;
+		image.width = width;
+		image.height = height;
+		image.pixels.resize(static_cast<size_t>(width) * height);
+
+		for (size_t i = 0; i < image.pixels.size(); i++)
+		{
+			const uint8_t* pixel = rgba + i * 4;
+			image.pixels[i] = static_cast<uint32_t>(pixel[0]) | (static_cast<uint32_t>(pixel[1]) << 8) | (static_cast<uint32_t>(pixel[2]) << 16) | (static_cast<uint32_t>(pixel[3]) << 24);
+		}
+
+		return image;
+	}
+
+	bool SavePpm(const Framebuffer& framebuffer, const std::string& path)
+	{
+		std::ofstream file(path, std::ios::binary);
+
+		if (!file)
+		{
+			return false;
+		}
+
+		file << "P6\n" << framebuffer.width << " " << framebuffer.height << "\n255\n";
+
+		std::vector<char> bytes(framebuffer.pixels.size() * 3);
+
+		for (size_t i = 0; i < framebuffer.pixels.size(); i++)
+		{
+			uint32_t pixel = framebuffer.pixels[i];
+
+			bytes[i * 3 + 0] = static_cast<char>(pixel & 0xFF);
+			bytes[i * 3 + 1] = static_cast<char>((pixel >> 8) & 0xFF);
+			bytes[i * 3 + 2] = static_cast<char>((pixel >> 16) & 0xFF);
+		}
+
+		file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+		return static_cast<bool>(file);
+	}
+
+	bool LoadPpm(Framebuffer& framebuffer, const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+
+		std::string magic;
+		int width = 0;
+		int height = 0;
+		int maxValue = 0;
+
+		if (!(file >> magic >> width >> height >> maxValue) || magic != "P6" || maxValue != 255 || width <= 0 || height <= 0)
+		{
+			return false;
+		}
+
+		file.get();
+
+		std::vector<char> bytes(static_cast<size_t>(width) * height * 3);
+
+		if (!file.read(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+		{
+			return false;
+		}
+
+		framebuffer.width = width;
+		framebuffer.height = height;
+		framebuffer.pixels.resize(static_cast<size_t>(width) * height);
+
+		for (size_t i = 0; i < framebuffer.pixels.size(); i++)
+		{
+			framebuffer.pixels[i] = static_cast<uint32_t>(static_cast<uint8_t>(bytes[i * 3])) | (static_cast<uint32_t>(static_cast<uint8_t>(bytes[i * 3 + 1])) << 8)
+				| (static_cast<uint32_t>(static_cast<uint8_t>(bytes[i * 3 + 2])) << 16) | 0xFF000000u;
+		}
+
+		return true;
+	}
+
+	long long CountDifferences(const Framebuffer& a, const Framebuffer& b, int tolerance)
+	{
+		if (a.width != b.width || a.height != b.height)
+		{
+			return -1;
+		}
+
+		long long differences = 0;
+
+		for (size_t i = 0; i < a.pixels.size(); i++)
+		{
+			for (int channel = 0; channel < 3; channel++)
+			{
+				int valueA = (a.pixels[i] >> (8 * channel)) & 0xFF;
+				int valueB = (b.pixels[i] >> (8 * channel)) & 0xFF;
+
+				if (std::abs(valueA - valueB) > tolerance)
+				{
+					differences++;
+					break;
+				}
+			}
+		}
+
+		return differences;
+	}
+}
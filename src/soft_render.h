@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+
+// CPU rasterizer for machines without a GPU. Draw calls only record commands into a Frame; Render rasterizes
+// them into an RGBA framebuffer tile by tile on the job system. Uses no raylib functions, only its plain types
+namespace SoftRender
+{
+	// Pixels are R, G, B, A bytes in memory, the same layout as raylib's R8G8B8A8 images
+	struct Image
+	{
+		int width = 0;
+		int height = 0;
+
+		std::vector<uint32_t> pixels;
+	};
+
+	typedef Image Framebuffer;
+
+	enum class CommandType
+	{
+		Rectangle, Circle, Image, Text
+	};
+
+	struct Command
+	{
+		CommandType type;
+
+		// Rectangle and image destination, circle center in x, y and radius in width, text origin and scale
+		float x;
+		float y;
+		float width;
+		float height;
+
+		Color color;
+
+		const Image* image;
+		std::string text;
+	};
+
+	struct Frame
+	{
+		int width;
+		int height;
+		Color clear;
+
+		// Applied to draw calls as they are recorded
+		Vector2 scale;
+
+		std::vector<Command> commands;
+	};
+
+	const int defaultTileSize = 64;
+
+	void Begin(Frame& frame, int width, int height, Color clear);
+
+	// Lets callers keep drawing in screen coordinates into a frame of another size
+	void SetScale(Frame& frame, float x, float y);
+
+	void FillRectangle(Frame& frame, int x, int y, int width, int height, Color color);
+	void FillCircle(Frame& frame, Vector2 center, float radius, Color color);
+
+	// Nearest neighbour scaled, multiplied by tint; the image has to outlive Render
+	void DrawImage(Frame& frame, const Image& image, float x, float y, float width, float height, Color tint);
+
+	// Built-in 5x7 font; fontSize follows raylib's default font, where 10 is one pixel per font pixel
+	void DrawString(Frame& frame, const std::string& text, int x, int y, int fontSize, Color color);
+	int MeasureString(const std::string& text, int fontSize);
+
+	void Render(const Frame& frame, Framebuffer& framebuffer, int tileSize = defaultTileSize);
+
+	Image FromRgba(int width, int height, const uint8_t* rgba);
+
+	// Binary PPM, alpha dropped; enough for golden images and piping into encoders
+	bool SavePpm(const Framebuffer& framebuffer, const std::string& path);
+	bool LoadPpm(Framebuffer& framebuffer, const std::string& path);
+
+	// Pixels where any channel differs by more than tolerance, or -1 if the sizes differ
+	long long CountDifferences(const Framebuffer& a, const Framebuffer& b, int tolerance);
+}
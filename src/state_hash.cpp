@@ -0,0 +1,462 @@
+#include "state_hash.h"
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace StateHash
+{
+	namespace Variables
+	{
+		const std::string fileHeader = "flappy-hashes";
+		const int fileVersion = 3;
+
+		const uint64_t prime1 = 0x9E3779B185EBCA87ull;
+		const uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+		const uint64_t prime3 = 0x165667B19E3779F9ull;
+		const uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+		const uint64_t prime5 = 0x27D4EB2F165667C5ull;
+	}
+
+	enum class FieldKind
+	{
+		Float, Bool, Int, Unsigned
+	};
+
+	struct FieldInfo
+	{
+		const char* name;
+		FieldKind kind;
+	};
+
+	static const FieldInfo birdFieldInfos[BirdFieldCount] =
+	{
+		{ "position.x", FieldKind::Float }, { "position.y", FieldKind::Float }, { "velocity", FieldKind::Float }, { "isOn", FieldKind::Bool }, { "score", FieldKind::Int }
+	};
+
+	static const FieldInfo worldFieldInfos[FieldCount - ObstacleBottomX] =
+	{
+		{ "obstacle.bottom.x", FieldKind::Float }, { "obstacle.bottom.y", FieldKind::Float }, { "obstacle.top.x", FieldKind::Float }, { "obstacle.top.y", FieldKind::Float }, { "obstacle.passed", FieldKind::Unsigned }, { "obstacle.velocity", FieldKind::Float },
+		{ "difficulty.levels.obstacleVelocity", FieldKind::Float }, { "difficulty.levels.gapSpace", FieldKind::Float }, { "difficulty.levels.obstacleSpacing", FieldKind::Float },
+		{ "difficulty.segments[0]", FieldKind::Int }, { "difficulty.segments[1]", FieldKind::Int }, { "difficulty.segments[2]", FieldKind::Int },
+		{ "rng.state", FieldKind::Unsigned }, { "rng.increment", FieldKind::Unsigned },
+		{ "tick", FieldKind::Unsigned }, { "score", FieldKind::Int }, { "timeAlive", FieldKind::Float }, { "hasLost", FieldKind::Bool }
+	};
+
+	static const FieldInfo& GetFieldInfo(int field);
+
+	static uint64_t Rotate(uint64_t value, int bits);
+	static uint64_t Read64(const uint8_t* bytes);
+	static uint32_t Read32(const uint8_t* bytes);
+	static uint64_t Round(uint64_t accumulator, uint64_t input);
+	static uint64_t Merge(uint64_t accumulator, uint64_t value);
+
+	static uint64_t FloatBits(float value);
+	static float BitsFloat(uint64_t bits);
+
+	static bool ReadHeader(std::ifstream& file, bool& hasFields);
+	static bool ReadRecord(std::ifstream& file, bool hasFields, unsigned long long& record, uint64_t& hash, Fields& fields);
+
+	uint64_t Rotate(uint64_t value, int bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	uint64_t Read64(const uint8_t* bytes)
+	{
+		uint64_t value = 0;
+
+		for (int i = 0; i < 8; i++)
+		{
+			value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+		}
+
+		return value;
+	}
+
+	uint32_t Read32(const uint8_t* bytes)
+	{
+		uint32_t value = 0;
+
+		for (int i = 0; i < 4; i++)
+		{
+			value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+		}
+
+		return value;
+	}
+
+	uint64_t Round(uint64_t accumulator, uint64_t input)
+	{
+		accumulator += input * Variables::prime2;
+		accumulator = Rotate(accumulator, 31);
+
+		return accumulator * Variables::prime1;
+	}
+
+	uint64_t Merge(uint64_t accumulator, uint64_t value)
+	{
+		accumulator ^= Round(0, value);
+
+		return accumulator * Variables::prime1 + Variables::prime4;
+	}
+
+	uint64_t FloatBits(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		return bits;
+	}
+
+	float BitsFloat(uint64_t bits)
+	{
+		uint32_t low = static_cast<uint32_t>(bits);
+		float value;
+		std::memcpy(&value, &low, sizeof(value));
+
+		return value;
+	}
+
+	uint64_t XXHash64(const void* data, size_t size, uint64_t seed)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		const uint8_t* end = bytes + size;
+
+		uint64_t hash;
+
+		if (size >= 32)
+		{
+			uint64_t lanes[4] = { seed + Variables::prime1 + Variables::prime2, seed + Variables::prime2, seed, seed - Variables::prime1 };
+
+			for (; end - bytes >= 32; bytes += 32)
+			{
+				for (int i = 0; i < 4; i++)
+				{
+					lanes[i] = Round(lanes[i], Read64(bytes + 8 * i));
+				}
+			}
+
+			hash = Rotate(lanes[0], 1) + Rotate(lanes[1], 7) + Rotate(lanes[2], 12) + Rotate(lanes[3], 18);
+
+			for (int i = 0; i < 4; i++)
+			{
+				hash = Merge(hash, lanes[i]);
+			}
+		}
+		else
+		{
+			hash = seed + Variables::prime5;
+		}
+
+		hash += size;
+
+		for (; end - bytes >= 8; bytes += 8)
+		{
+			hash ^= Round(0, Read64(bytes));
+			hash = Rotate(hash, 27) * Variables::prime1 + Variables::prime4;
+		}
+
+		if (end - bytes >= 4)
+		{
+			hash ^= Read32(bytes) * Variables::prime1;
+			hash = Rotate(hash, 23) * Variables::prime2 + Variables::prime3;
+			bytes += 4;
+		}
+
+		for (; bytes < end; bytes++)
+		{
+			hash ^= *bytes * Variables::prime5;
+			hash = Rotate(hash, 11) * Variables::prime1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= Variables::prime2;
+		hash ^= hash >> 29;
+		hash *= Variables::prime3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+
+	void Gather(const World::World& world, Fields& fields)
+	{
+		uint64_t* values = fields.values;
+
+		for (int i = 0; i < World::maxPlayers; i++)
+		{
+			const Player::Bird& bird = world.birds[i];
+			uint64_t* birdValues = values + i * BirdFieldCount;
+
+			birdValues[BirdX] = FloatBits(bird.position.x);
+			birdValues[BirdY] = FloatBits(bird.position.y);
+			birdValues[BirdVelocity] = FloatBits(bird.velocity);
+			birdValues[BirdIsOn] = bird.isOn ? 1 : 0;
+			birdValues[BirdScore] = static_cast<uint64_t>(static_cast<int64_t>(world.scores[i]));
+		}
+
+		values[ObstacleBottomX] = FloatBits(world.obstacle.bottom.x);
+		values[ObstacleBottomY] = FloatBits(world.obstacle.bottom.y);
+		values[ObstacleTopX] = FloatBits(world.obstacle.top.x);
+		values[ObstacleTopY] = FloatBits(world.obstacle.top.y);
+		values[ObstaclePassed] = world.obstacle.passed;
+		values[ObstacleVelocity] = FloatBits(world.obstacle.velocity);
+
+		values[DifficultyVelocity] = FloatBits(world.difficulty.levels.obstacleVelocity);
+		values[DifficultyGap] = FloatBits(world.difficulty.levels.gapSpace);
+		values[DifficultySpacing] = FloatBits(world.difficulty.levels.obstacleSpacing);
+		values[DifficultyVelocitySegment] = world.difficulty.segments[0];
+		values[DifficultyGapSegment] = world.difficulty.segments[1];
+		values[DifficultySpacingSegment] = world.difficulty.segments[2];
+
+		values[RngState] = world.rng.state;
+		values[RngIncrement] = world.rng.increment;
+
+		values[Tick] = world.tick;
+		values[Score] = static_cast<uint64_t>(static_cast<int64_t>(world.score));
+		values[TimeAlive] = FloatBits(world.timeAlive);
+		values[HasLost] = world.hasLost ? 1 : 0;
+	}
+
+	uint64_t Hash(const Fields& fields)
+	{
+		// Serialized little endian so the hash is the same on every platform
+		uint8_t bytes[FieldCount * 8];
+
+		for (int field = 0; field < FieldCount; field++)
+		{
+			for (int i = 0; i < 8; i++)
+			{
+				bytes[field * 8 + i] = static_cast<uint8_t>(fields.values[field] >> (8 * i));
+			}
+		}
+
+		return XXHash64(bytes, sizeof(bytes), 0);
+	}
+
+	uint64_t Hash(const World::World& world)
+	{
+		Fields fields;
+		Gather(world, fields);
+
+		return Hash(fields);
+	}
+
+	const FieldInfo& GetFieldInfo(int field)
+	{
+		if (field < ObstacleBottomX)
+		{
+			return birdFieldInfos[field % BirdFieldCount];
+		}
+
+		return worldFieldInfos[field - ObstacleBottomX];
+	}
+
+	std::string GetFieldName(int field)
+	{
+		if (field < 0 || field >= FieldCount)
+		{
+			return "unknown";
+		}
+
+		if (field < ObstacleBottomX)
+		{
+			return "birds[" + std::to_string(field / BirdFieldCount) + "]." + GetFieldInfo(field).name;
+		}
+
+		return GetFieldInfo(field).name;
+	}
+
+	std::string FormatField(int field, uint64_t value)
+	{
+		std::ostringstream text;
+
+		switch (field >= 0 && field < FieldCount ? GetFieldInfo(field).kind : FieldKind::Unsigned)
+		{
+		case FieldKind::Float:
+			text << std::setprecision(9) << BitsFloat(value) << " (0x" << std::hex << std::setw(8) << std::setfill('0') << value << ")";
+			break;
+
+		case FieldKind::Bool:
+			text << (value != 0 ? "true" : "false");
+			break;
+
+		case FieldKind::Int:
+			text << static_cast<int64_t>(value);
+			break;
+
+		default:
+			text << "0x" << std::hex << std::setw(16) << std::setfill('0') << value;
+			break;
+		}
+
+		return text.str();
+	}
+
+	bool Open(Log& log, const std::string& path, bool hasFields)
+	{
+		log.file.open(path);
+		log.hasFields = hasFields;
+		log.records = 0;
+		log.chain = 0;
+
+		if (!log.file)
+		{
+			return false;
+		}
+
+		log.file << Variables::fileHeader << " " << Variables::fileVersion << " " << (hasFields ? FieldCount : 0) << "\n";
+		log.file << std::hex;
+
+		return static_cast<bool>(log.file);
+	}
+
+	void Record(Log& log, const World::World& world)
+	{
+		Fields fields;
+		Gather(world, fields);
+
+		uint64_t hash = Hash(fields);
+		log.chain = XXHash64(&hash, sizeof(hash), log.chain);
+
+		if (!log.file.is_open())
+		{
+			return;
+		}
+
+		log.file << log.records << " " << hash;
+
+		if (log.hasFields)
+		{
+			for (int field = 0; field < FieldCount; field++)
+			{
+				log.file << " " << fields.values[field];
+			}
+		}
+
+		log.file << "\n";
+		log.records++;
+	}
+
+	void Close(Log& log)
+	{
+		if (log.file.is_open())
+		{
+			log.file.close();
+		}
+	}
+
+	bool ReadHeader(std::ifstream& file, bool& hasFields)
+	{
+		std::string header;
+		int version = 0;
+		int fieldCount = -1;
+
+		if (!(file >> header >> version >> fieldCount) || header != Variables::fileHeader || version != Variables::fileVersion || (fieldCount != 0 && fieldCount != FieldCount))
+		{
+			return false;
+		}
+
+		hasFields = fieldCount != 0;
+		file >> std::hex;
+
+		return true;
+	}
+
+	bool ReadRecord(std::ifstream& file, bool hasFields, unsigned long long& record, uint64_t& hash, Fields& fields)
+	{
+		if (!(file >> record >> hash))
+		{
+			return false;
+		}
+
+		for (int field = 0; hasFields && field < FieldCount; field++)
+		{
+			if (!(file >> fields.values[field]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	int Diff(const std::string& pathA, const std::string& pathB)
+	{
+		std::ifstream fileA(pathA);
+		std::ifstream fileB(pathB);
+
+		bool hasFieldsA = false;
+		bool hasFieldsB = false;
+
+		if (!ReadHeader(fileA, hasFieldsA) || !ReadHeader(fileB, hasFieldsB))
+		{
+			std::cerr << "not a hash log: " << (fileA ? pathB : pathA) << "\n";
+			return 2;
+		}
+
+		unsigned long long recordA = 0;
+		unsigned long long recordB = 0;
+		uint64_t hashA = 0;
+		uint64_t hashB = 0;
+		Fields fieldsA = {};
+		Fields fieldsB = {};
+
+		unsigned long long compared = 0;
+
+		while (true)
+		{
+			bool hasA = ReadRecord(fileA, hasFieldsA, recordA, hashA, fieldsA);
+			bool hasB = ReadRecord(fileB, hasFieldsB, recordB, hashB, fieldsB);
+
+			if (!hasA || !hasB)
+			{
+				if (hasA != hasB)
+				{
+					std::cout << "logs agree for " << compared << " records, then " << (hasA ? pathB : pathA) << " ends\n";
+					return 1;
+				}
+
+				std::cout << "logs match over " << compared << " records\n";
+				return 0;
+			}
+
+			if (hashA != hashB)
+			{
+				break;
+			}
+
+			compared++;
+		}
+
+		std::cout << "first divergence at record " << recordA << " (tick " << std::dec;
+
+		if (hasFieldsA)
+		{
+			std::cout << fieldsA.values[Tick];
+		}
+		else
+		{
+			std::cout << "unknown";
+		}
+
+		std::cout << ")\n" << std::hex << "  hash " << hashA << " vs " << hashB << "\n" << std::dec;
+
+		if (!hasFieldsA || !hasFieldsB)
+		{
+			std::cout << "  record both logs with fields to see which values differ\n";
+			return 1;
+		}
+
+		for (int field = 0; field < FieldCount; field++)
+		{
+			if (fieldsA.values[field] != fieldsB.values[field])
+			{
+				std::cout << "  " << GetFieldName(field) << ": " << FormatField(field, fieldsA.values[field]) << " vs " << FormatField(field, fieldsB.values[field]) << "\n";
+			}
+		}
+
+		return 1;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "world.h"
+
+namespace StateHash
+{
+	// Every value World::Update can change, in a fixed order; the log and the diff tool both rely on it.
+	// Each player slot has birdFieldCount fields starting at player * birdFieldCount, the rest of the world follows
+	enum BirdField
+	{
+		BirdX, BirdY, BirdVelocity, BirdIsOn, BirdScore,
+		BirdFieldCount
+	};
+
+	enum Field
+	{
+		ObstacleBottomX = World::maxPlayers * BirdFieldCount, ObstacleBottomY, ObstacleTopX, ObstacleTopY, ObstaclePassed, ObstacleVelocity,
+		DifficultyVelocity, DifficultyGap, DifficultySpacing, DifficultyVelocitySegment, DifficultyGapSegment, DifficultySpacingSegment,
+		RngState, RngIncrement,
+		Tick, Score, TimeAlive, HasLost,
+		FieldCount
+	};
+
+	// Raw bit patterns, so a single flipped mantissa bit is a difference
+	struct Fields
+	{
+		uint64_t values[FieldCount];
+	};
+
+	uint64_t XXHash64(const void* data, size_t size, uint64_t seed);
+
+	void Gather(const World::World& world, Fields& fields);
+	uint64_t Hash(const Fields& fields);
+	uint64_t Hash(const World::World& world);
+
+	std::string GetFieldName(int field);
+	std::string FormatField(int field, uint64_t value);
+
+	// One line per recorded tick: record number, state hash and optionally every field
+	struct Log
+	{
+		std::ofstream file;
+		bool hasFields;
+
+		unsigned long long records;
+
+		// Hash of every state so far, chained; equal chains mean equal runs
+		uint64_t chain;
+	};
+
+	bool Open(Log& log, const std::string& path, bool hasFields);
+	void Record(Log& log, const World::World& world);
+	void Close(Log& log);
+
+	// Prints the first record where the logs disagree and which fields differ. Returns 0 when they match, 1 when they don't, 2 on a bad file
+	int Diff(const std::string& pathA, const std::string& pathB);
+}
@@ -0,0 +1,376 @@
+#include "sweep.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "job_system.h"
+#include "policy.h"
+#include "rng.h"
+#include "tuning.h"
+
+namespace Sweep
+{
+	// Scores this high and up share the last bin
+	const int scoreBins = 256;
+
+	struct Counts
+	{
+		// deaths[i] is rounds lost between i and i + 1 curve steps in
+		std::vector<long long> deaths;
+		std::vector<long long> scores;
+
+		long long survivors = 0;
+		long long steps = 0;
+		long long scoreSum = 0;
+		double timeSum = 0.0;
+		int bestScore = 0;
+
+		// Per worker accumulators, kept apart to avoid false sharing
+		char padding[64];
+	};
+
+	static bool IsRuleFlapping(const World::World& world);
+	static void PlayCell(const Config& config, const Tuning::Tuning& tuning, const Policy::Network* policy, int binCount, std::vector<Counts>& counts);
+	static int GetScoreAt(const Counts& counts, double fraction);
+	static double GetAliveAt(const Counts& counts, double episodes, int bin);
+
+	bool ParseValues(std::vector<float>& values, const std::string& text)
+	{
+		values.clear();
+
+		size_t colon = text.find(':');
+
+		if (colon != std::string::npos)
+		{
+			size_t second = text.find(':', colon + 1);
+
+			if (second == std::string::npos)
+			{
+				return false;
+			}
+
+			char* end;
+			float from = std::strtof(text.c_str(), &end);
+			bool isValid = end == text.c_str() + colon;
+			float to = std::strtof(text.c_str() + colon + 1, &end);
+			isValid = isValid && end == text.c_str() + second;
+			float step = std::strtof(text.c_str() + second + 1, &end);
+			isValid = isValid && *end == '\0' && step > 0.0f && to >= from;
+
+			// Counted rather than added up, so float steps don't drop or add the last value
+			float count = std::floor((to - from) / step + 1e-3f) + 1.0f;
+
+			if (!isValid || count > 1000.0f)
+			{
+				return false;
+			}
+
+			for (int i = 0; i < static_cast<int>(count); i++)
+			{
+				values.push_back(from + step * i);
+			}
+
+			return true;
+		}
+
+		size_t start = 0;
+
+		while (start <= text.size())
+		{
+			size_t comma = std::min(text.find(',', start), text.size());
+			std::string item = text.substr(start, comma - start);
+
+			char* end;
+			float value = std::strtof(item.c_str(), &end);
+
+			if (item.empty() || *end != '\0')
+			{
+				return false;
+			}
+
+			values.push_back(value);
+			start = comma + 1;
+		}
+
+		return true;
+	}
+
+	bool IsRuleFlapping(const World::World& world)
+	{
+		// Where the bird will be after this tick without a flap, against the lowest it can be in the gap
+		const Tuning::Tuning& tuning = Tuning::Get();
+		const Player::Bird& bird = world.birds[0];
+
+		float nextY = bird.position.y - (bird.velocity - tuning.gravity * world.deltaT) * world.deltaT;
+
+		return nextY > world.obstacle.top.y - tuning.birdRadius;
+	}
+
+	void PlayCell(const Config& config, const Tuning::Tuning& tuning, const Policy::Network* policy, int binCount, std::vector<Counts>& counts)
+	{
+		for (Counts& local : counts)
+		{
+			local.deaths.assign(binCount, 0);
+			local.scores.assign(scoreBins + 1, 0);
+			local.survivors = 0;
+			local.steps = 0;
+			local.scoreSum = 0;
+			local.timeSum = 0.0;
+			local.bestScore = 0;
+		}
+
+		Jobs::ParallelFor(config.episodes, config.chunkSize, [&](int begin, int end, int worker)
+		{
+			// The cell's tuning goes to the workers directly; the process-wide one stays as it was
+			Tuning::SetOverride(&tuning);
+			Counts& local = counts[worker];
+
+			for (int i = begin; i < end; i++)
+			{
+				World::World world;
+				World::Reset(world, 1, config.seed + static_cast<uint64_t>(i));
+				world.deltaT = config.deltaT;
+
+				Rng::Rng botRng;
+				Rng::Seed(botRng, config.seed, static_cast<uint64_t>(i) + 1);
+
+				while (!world.hasLost && world.timeAlive < config.maxTime)
+				{
+					bool isMoving;
+
+					switch (config.bot)
+					{
+					case Bot::Rule:
+						isMoving = IsRuleFlapping(world);
+						break;
+
+					case Bot::Policy:
+						isMoving = Policy::Evaluate(*policy, World::Observe(world.birds[0], world.obstacle));
+						break;
+
+					default:
+						isMoving = Rng::Float(botRng) < config.flapChance;
+						break;
+					}
+
+					World::Step<1>(world, isMoving ? 1 : 0);
+					local.steps++;
+				}
+
+				if (world.hasLost)
+				{
+					local.deaths[std::min(binCount - 1, static_cast<int>(world.timeAlive / config.curveStep))]++;
+				}
+				else
+				{
+					local.survivors++;
+				}
+
+				local.scores[std::min(world.score, scoreBins)]++;
+				local.scoreSum += world.score;
+				local.timeSum += world.timeAlive;
+				local.bestScore = std::max(local.bestScore, world.score);
+			}
+
+			Tuning::SetOverride(nullptr);
+		});
+
+		// Everything ends up in the first worker's counts
+		for (size_t worker = 1; worker < counts.size(); worker++)
+		{
+			const Counts& local = counts[worker];
+
+			for (int bin = 0; bin < binCount; bin++)
+			{
+				counts[0].deaths[bin] += local.deaths[bin];
+			}
+
+			for (int score = 0; score <= scoreBins; score++)
+			{
+				counts[0].scores[score] += local.scores[score];
+			}
+
+			counts[0].survivors += local.survivors;
+			counts[0].steps += local.steps;
+			counts[0].scoreSum += local.scoreSum;
+			counts[0].timeSum += local.timeSum;
+			counts[0].bestScore = std::max(counts[0].bestScore, local.bestScore);
+		}
+	}
+
+	int GetScoreAt(const Counts& counts, double fraction)
+	{
+		long long total = 0;
+
+		for (long long count : counts.scores)
+		{
+			total += count;
+		}
+
+		long long seen = 0;
+
+		for (int score = 0; score <= scoreBins; score++)
+		{
+			seen += counts.scores[score];
+
+			if (seen >= fraction * total)
+			{
+				return score;
+			}
+		}
+
+		return scoreBins;
+	}
+
+	double GetAliveAt(const Counts& counts, double episodes, int bin)
+	{
+		// Share of rounds still going at the start of the bin
+		long long lost = 0;
+
+		for (int i = 0; i < bin && i < static_cast<int>(counts.deaths.size()); i++)
+		{
+			lost += counts.deaths[i];
+		}
+
+		return 1.0 - lost / episodes;
+	}
+
+	int Run(const Config& config)
+	{
+		if (config.episodes < 1 || config.chunkSize < 1 || !(config.deltaT > 0.0f) || !(config.maxTime > 0.0f) || !(config.curveStep > 0.0f))
+		{
+			std::cerr << "episodes, chunk, dt, max time and curve step must be positive\n";
+			return 1;
+		}
+
+		if (config.velocities.empty() || config.gaps.empty() || config.spacings.empty())
+		{
+			std::cerr << "every axis needs at least one value\n";
+			return 1;
+		}
+
+		Policy::Network policy;
+
+		if (config.bot == Bot::Policy && !Policy::Load(policy, config.policyPath))
+		{
+			std::cerr << "could not load policy " << config.policyPath << "\n";
+			return 1;
+		}
+
+		// Every cell's tuning is checked before any of them plays, so a typo doesn't show up minutes into the sweep
+		const Tuning::Tuning base = Tuning::Get();
+		std::vector<Tuning::Tuning> cells;
+
+		for (float velocity : config.velocities)
+		{
+			for (float gap : config.gaps)
+			{
+				for (float spacing : config.spacings)
+				{
+					Tuning::Tuning tuning = base;
+					tuning.obstacleVelocity = velocity;
+					tuning.gapSpace = gap;
+					tuning.obstacleSpacing = spacing;
+					tuning.obstacleVelocityCurve.pointCount = 0;
+					tuning.gapSpaceCurve.pointCount = 0;
+					tuning.obstacleSpacingCurve.pointCount = 0;
+
+					if (!Tuning::IsValid(tuning))
+					{
+						std::cerr << "speed " << velocity << ", gap " << gap << ", spacing " << spacing << " is out of the range the tuning allows\n";
+						return 1;
+					}
+
+					cells.push_back(tuning);
+				}
+			}
+		}
+
+		std::ofstream csv;
+
+		if (!config.csvPath.empty())
+		{
+			csv.open(config.csvPath);
+
+			if (!csv)
+			{
+				std::cerr << "could not write " << config.csvPath << "\n";
+				return 1;
+			}
+
+			csv << "speed,gap,spacing,kind,at,value\n";
+		}
+
+		Jobs::Initialize(config.threadCount, config.pinThreads);
+
+		int binCount = static_cast<int>(std::ceil(config.maxTime / config.curveStep));
+		double episodes = config.episodes;
+		long long totalSteps = 0;
+
+		std::vector<Counts> counts(Jobs::GetThreadCount());
+
+		auto start = std::chrono::steady_clock::now();
+
+		for (const Tuning::Tuning& tuning : cells)
+		{
+			// One cell at a time: every cell already fills the pool, and the counts are per worker, not per cell
+			PlayCell(config, tuning, config.bot == Bot::Policy ? &policy : nullptr, binCount, counts);
+
+			const Counts& cell = counts[0];
+			totalSteps += cell.steps;
+
+			std::cout << "speed " << tuning.obstacleVelocity << "  gap " << tuning.gapSpace << "  spacing " << tuning.obstacleSpacing << ":  mean score "
+				<< cell.scoreSum / episodes << "  median " << GetScoreAt(cell, 0.5) << "  p90 " << GetScoreAt(cell, 0.9) << "  best " << cell.bestScore
+				<< "  mean time " << cell.timeSum / episodes << " s  alive at";
+
+			// The curve at its quarters, the last being the share that made it to max time
+			for (int quarter = 1; quarter <= 4; quarter++)
+			{
+				double alive = quarter == 4 ? cell.survivors / episodes : GetAliveAt(cell, episodes, binCount * quarter / 4);
+
+				std::cout << " " << config.maxTime * quarter / 4 << " s " << 100.0 * alive << "%";
+			}
+
+			std::cout << "\n";
+
+			if (!csv.is_open())
+			{
+				continue;
+			}
+
+			for (int bin = 0; bin <= binCount; bin++)
+			{
+				double alive = bin == binCount ? cell.survivors / episodes : GetAliveAt(cell, episodes, bin);
+
+				csv << tuning.obstacleVelocity << "," << tuning.gapSpace << "," << tuning.obstacleSpacing << ",alive," << std::min(bin * config.curveStep, config.maxTime) << "," << alive << "\n";
+			}
+
+			for (int score = 0; score <= scoreBins; score++)
+			{
+				if (cell.scores[score] > 0)
+				{
+					csv << tuning.obstacleVelocity << "," << tuning.gapSpace << "," << tuning.obstacleSpacing << ",score," << score << "," << cell.scores[score] / episodes << "\n";
+				}
+			}
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		Jobs::Shutdown();
+
+		std::cout << cells.size() << " cells, " << cells.size() * static_cast<unsigned long long>(config.episodes) << " episodes in " << seconds << " s on "
+			<< counts.size() << " threads  " << cells.size() * episodes / seconds << " episodes/s  " << totalSteps / seconds << " steps/s\n";
+
+		if (csv.is_open() && !csv)
+		{
+			std::cerr << "could not write " << config.csvPath << "\n";
+			return 1;
+		}
+
+		return 0;
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "world.h"
+
+// Plays a batch of rounds for every combination of obstacle speed, gap and spacing in a grid, and reports how long
+// birds last and what they score under each. Each cell's tuning is handed to the workers through Tuning::SetOverride,
+// leaving the shared tuning untouched, and a cell runs on every core at once; cells play the same seeds, so differences
+// between them come from the setting alone
+namespace Sweep
+{
+	enum class Bot
+	{
+		// Flaps with flapChance every tick
+		Random,
+		// Flaps when the bird is about to sink below the gap, so it hovers at its bottom
+		Rule,
+		// The policy at policyPath
+		Policy
+	};
+
+	struct Config
+	{
+		// Values of each axis; the grid is every combination. Difficulty curves on a swept axis are dropped
+		std::vector<float> velocities = { 400.0f, 500.0f, 600.0f };
+		std::vector<float> gaps = { 160.0f, 200.0f, 240.0f };
+		std::vector<float> spacings = { 0.0f };
+
+		int episodes = 100000;
+		int chunkSize = 64;
+		int threadCount = 0;
+		bool pinThreads = false;
+
+		float deltaT = World::defaultDeltaT;
+		float maxTime = 60.0f;
+
+		Bot bot = Bot::Random;
+		float flapChance = 0.06f;
+		std::string policyPath;
+
+		// Width of the survival curve's bins
+		float curveStep = 1.0f;
+
+		// Writes each cell's survival curve and score distribution here as CSV when set
+		std::string csvPath;
+
+		uint64_t seed = 1;
+	};
+
+	// Reads "a,b,c" or "from:to:step" into values; false on anything else
+	bool ParseValues(std::vector<float>& values, const std::string& text);
+
+	int Run(const Config& config);
+}
@@ -0,0 +1,504 @@
+#include "telemetry.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The C runtime's calls, since windows.h clashes with raylib.h
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "player.h"
+
+namespace Telemetry
+{
+	namespace Variables
+	{
+		const char fileMagic[8] = { 'F', 'L', 'A', 'P', 'T', 'E', 'L', 'E' };
+		const uint32_t fileVersion = 1;
+		const size_t headerSize = 16;
+
+		static std::thread writer;
+		static std::mutex mutex;
+		static std::condition_variable changed;
+
+		// Ring of runs the writer has not taken yet
+		static Run buffer[bufferCapacity];
+		static int head = 0;
+		static int count = 0;
+
+		static bool isRunning = false;
+		static bool isStopping = false;
+		static unsigned long long droppedCount = 0;
+
+		static std::ofstream file;
+	}
+
+	static void Write();
+	static bool Truncate(const std::string& path, uint64_t size);
+
+	static void PutInteger(uint8_t*& out, uint64_t value, int size);
+	static void PutFloat(uint8_t*& out, float value);
+	static uint64_t GetInteger(const uint8_t*& in, int size);
+	static float GetFloat(const uint8_t*& in);
+
+	static void Serialize(const Run& run, uint8_t* out);
+	static void Deserialize(const uint8_t* in, Run& run);
+	static bool ReadHeader(std::ifstream& file);
+
+	void PutInteger(uint8_t*& out, uint64_t value, int size)
+	{
+		for (int i = 0; i < size; i++)
+		{
+			*out++ = static_cast<uint8_t>(value >> (8 * i));
+		}
+	}
+
+	void PutFloat(uint8_t*& out, float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		PutInteger(out, bits, 4);
+	}
+
+	uint64_t GetInteger(const uint8_t*& in, int size)
+	{
+		uint64_t value = 0;
+
+		for (int i = 0; i < size; i++)
+		{
+			value |= static_cast<uint64_t>(*in++) << (8 * i);
+		}
+
+		return value;
+	}
+
+	float GetFloat(const uint8_t*& in)
+	{
+		uint32_t bits = static_cast<uint32_t>(GetInteger(in, 4));
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+
+		return value;
+	}
+
+	void Serialize(const Run& run, uint8_t* out)
+	{
+		PutInteger(out, run.startTime, 8);
+		PutInteger(out, run.seed, 8);
+		PutInteger(out, run.ticks, 8);
+		PutFloat(out, run.timeAlive);
+		PutInteger(out, static_cast<uint32_t>(run.score), 4);
+
+		PutInteger(out, run.playerCount, 1);
+		PutInteger(out, run.flags, 1);
+		PutInteger(out, static_cast<uint8_t>(run.cause), 1);
+
+		PutFloat(out, run.deathX);
+		PutFloat(out, run.deathY);
+		PutFloat(out, run.deathVelocity);
+		PutFloat(out, run.obstacleX);
+		PutFloat(out, run.gapTop);
+		PutFloat(out, run.gapBottom);
+
+		PutInteger(out, run.frames, 4);
+		PutInteger(out, run.missedFrames, 4);
+		PutFloat(out, run.frameTimeMean);
+		PutFloat(out, run.frameTimeWorst);
+	}
+
+	void Deserialize(const uint8_t* in, Run& run)
+	{
+		run.startTime = GetInteger(in, 8);
+		run.seed = GetInteger(in, 8);
+		run.ticks = GetInteger(in, 8);
+		run.timeAlive = GetFloat(in);
+		run.score = static_cast<int32_t>(GetInteger(in, 4));
+
+		run.playerCount = static_cast<uint8_t>(GetInteger(in, 1));
+		run.flags = static_cast<uint8_t>(GetInteger(in, 1));
+		run.cause = static_cast<DeathCause>(GetInteger(in, 1));
+
+		run.deathX = GetFloat(in);
+		run.deathY = GetFloat(in);
+		run.deathVelocity = GetFloat(in);
+		run.obstacleX = GetFloat(in);
+		run.gapTop = GetFloat(in);
+		run.gapBottom = GetFloat(in);
+
+		run.frames = static_cast<uint32_t>(GetInteger(in, 4));
+		run.missedFrames = static_cast<uint32_t>(GetInteger(in, 4));
+		run.frameTimeMean = GetFloat(in);
+		run.frameTimeWorst = GetFloat(in);
+	}
+
+	void Begin(Run& run, const World::World& world, uint8_t flags)
+	{
+		run = Run();
+		run.startTime = static_cast<uint64_t>(std::time(nullptr));
+		run.seed = world.seed;
+		run.playerCount = static_cast<uint8_t>(world.playerCount);
+		run.flags = flags;
+		run.cause = DeathCause::None;
+	}
+
+	void AddFrame(Run& run, float frameTime)
+	{
+		run.frames++;
+		run.frameTimeMean += (frameTime - run.frameTimeMean) / static_cast<float>(run.frames);
+		run.frameTimeWorst = std::max(run.frameTimeWorst, frameTime);
+	}
+
+	void SetDeath(Run& run, const World::World& world)
+	{
+		bool isHit = (world.events & World::Events::hit) != 0;
+
+		// The bird that went out on this tick: the one that hit the obstacle, or the one below the screen
+		for (int i = 0; i < world.playerCount; i++)
+		{
+			const Player::Bird& bird = world.birds[i];
+
+			if (isHit ? (world.hits & (1 << i)) != 0 : Player::HasLost(bird))
+			{
+				run.cause = isHit ? DeathCause::Obstacle : DeathCause::Fall;
+				run.deathX = bird.position.x;
+				run.deathY = bird.position.y;
+				run.deathVelocity = bird.velocity;
+				break;
+			}
+		}
+
+		run.obstacleX = world.obstacle.bottom.x;
+		run.gapTop = world.obstacle.bottom.y + world.obstacle.height;
+		run.gapBottom = world.obstacle.top.y;
+	}
+
+	void Finish(Run& run, const World::World& world, uint32_t missedFrames)
+	{
+		run.ticks = world.tick;
+		run.timeAlive = world.timeAlive;
+		run.score = world.score;
+		run.missedFrames = missedFrames;
+
+		if (run.cause == DeathCause::None)
+		{
+			run.cause = DeathCause::Quit;
+		}
+	}
+
+	bool ReadHeader(std::ifstream& file)
+	{
+		uint8_t header[Variables::headerSize];
+
+		if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || std::memcmp(header, Variables::fileMagic, sizeof(Variables::fileMagic)) != 0)
+		{
+			return false;
+		}
+
+		const uint8_t* in = header + sizeof(Variables::fileMagic);
+
+		return GetInteger(in, 4) == Variables::fileVersion && GetInteger(in, 4) == recordSize;
+	}
+
+	bool Truncate(const std::string& path, uint64_t size)
+	{
+#if defined(_WIN32)
+		int descriptor = -1;
+
+		if (_sopen_s(&descriptor, path.c_str(), _O_RDWR | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE) != 0)
+		{
+			return false;
+		}
+
+		bool isDone = _chsize_s(descriptor, static_cast<long long>(size)) == 0;
+		_close(descriptor);
+
+		return isDone;
+#else
+		return truncate(path.c_str(), static_cast<off_t>(size)) == 0;
+#endif
+	}
+
+	bool Start(const std::string& path)
+	{
+		if (Variables::isRunning)
+		{
+			Stop();
+		}
+
+		{
+			std::ifstream existing(path, std::ios::binary | std::ios::ate);
+
+			// Only ever append to a log of this exact format, anything else stays untouched
+			if (existing && existing.tellg() > 0)
+			{
+				size_t size = static_cast<size_t>(existing.tellg());
+				existing.seekg(0);
+
+				if (!ReadHeader(existing))
+				{
+					return false;
+				}
+
+				size_t tornBytes = (size - Variables::headerSize) % recordSize;
+
+				existing.close();
+
+				// A crash in the middle of a write leaves a torn record; cutting it off keeps the runs after it aligned
+				if (tornBytes > 0 && !Truncate(path, size - tornBytes))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				std::ofstream created(path, std::ios::binary);
+
+				uint8_t header[Variables::headerSize];
+				uint8_t* out = header;
+
+				std::memcpy(out, Variables::fileMagic, sizeof(Variables::fileMagic));
+				out += sizeof(Variables::fileMagic);
+				PutInteger(out, Variables::fileVersion, 4);
+				PutInteger(out, recordSize, 4);
+
+				if (!created.write(reinterpret_cast<const char*>(header), sizeof(header)))
+				{
+					return false;
+				}
+			}
+		}
+
+		Variables::file.open(path, std::ios::binary | std::ios::app);
+
+		if (!Variables::file)
+		{
+			return false;
+		}
+
+		Variables::head = 0;
+		Variables::count = 0;
+		Variables::isStopping = false;
+		Variables::isRunning = true;
+		Variables::writer = std::thread(Write);
+
+		return true;
+	}
+
+	bool Push(const Run& run)
+	{
+		std::lock_guard<std::mutex> lock(Variables::mutex);
+
+		if (!Variables::isRunning)
+		{
+			return false;
+		}
+
+		if (Variables::count == bufferCapacity)
+		{
+			Variables::droppedCount++;
+			return false;
+		}
+
+		Variables::buffer[(Variables::head + Variables::count) % bufferCapacity] = run;
+		Variables::count++;
+		Variables::changed.notify_one();
+
+		return true;
+	}
+
+	void Write()
+	{
+		std::vector<uint8_t> bytes;
+		std::unique_lock<std::mutex> lock(Variables::mutex);
+
+		while (true)
+		{
+			Variables::changed.wait(lock, []() { return Variables::count > 0 || Variables::isStopping; });
+
+			if (Variables::count == 0)
+			{
+				return;
+			}
+
+			// Take everything buffered, then let the game push again while this batch goes to disk
+			bytes.resize(static_cast<size_t>(Variables::count) * recordSize);
+
+			for (int i = 0; i < Variables::count; i++)
+			{
+				Serialize(Variables::buffer[(Variables::head + i) % bufferCapacity], bytes.data() + static_cast<size_t>(i) * recordSize);
+			}
+
+			Variables::head = (Variables::head + Variables::count) % bufferCapacity;
+			Variables::count = 0;
+
+			lock.unlock();
+
+			Variables::file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			Variables::file.flush();
+
+			lock.lock();
+		}
+	}
+
+	void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Variables::mutex);
+
+			if (!Variables::isRunning)
+			{
+				return;
+			}
+
+			Variables::isStopping = true;
+			Variables::changed.notify_one();
+		}
+
+		Variables::writer.join();
+		Variables::file.close();
+
+		std::lock_guard<std::mutex> lock(Variables::mutex);
+		Variables::isRunning = false;
+	}
+
+	unsigned long long GetDroppedCount()
+	{
+		std::lock_guard<std::mutex> lock(Variables::mutex);
+		return Variables::droppedCount;
+	}
+
+	bool Open(Reader& reader, const std::string& path)
+	{
+		reader.file.open(path, std::ios::binary);
+
+		return reader.file && ReadHeader(reader.file);
+	}
+
+	size_t Read(Reader& reader, Run* runs, size_t maxCount)
+	{
+		std::vector<uint8_t> bytes(maxCount * recordSize);
+
+		reader.file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+		// A torn record at the very end, from a crash mid-write, is left out
+		size_t count = static_cast<size_t>(reader.file.gcount()) / recordSize;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			Deserialize(bytes.data() + i * recordSize, runs[i]);
+		}
+
+		return count;
+	}
+
+	const char* GetCauseName(DeathCause cause)
+	{
+		switch (cause)
+		{
+		case DeathCause::Obstacle:
+			return "obstacle";
+
+		case DeathCause::Fall:
+			return "fall";
+
+		case DeathCause::Quit:
+			return "quit";
+
+		default:
+			return "none";
+		}
+	}
+
+	int Summarize(const std::string& path, bool isCsv)
+	{
+		Reader reader;
+
+		if (!Open(reader, path))
+		{
+			std::cerr << "could not read telemetry log " << path << "\n";
+			return 2;
+		}
+
+		if (isCsv)
+		{
+			std::cout << "start,seed,ticks,time_alive,score,players,flags,cause,death_x,death_y,death_velocity,obstacle_x,gap_top,gap_bottom,frames,missed_frames,frame_time_mean,frame_time_worst\n";
+		}
+
+		const size_t blockSize = 4096;
+		std::vector<Run> runs(blockSize);
+
+		unsigned long long runCount = 0;
+		unsigned long long causeCounts[4] = {};
+		unsigned long long totalFrames = 0;
+		unsigned long long totalMissed = 0;
+		long long totalScore = 0;
+		int bestScore = 0;
+		double totalTime = 0.0;
+		double totalFrameTime = 0.0;
+		float worstFrameTime = 0.0f;
+
+		while (size_t count = Read(reader, runs.data(), blockSize))
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				const Run& run = runs[i];
+
+				if (isCsv)
+				{
+					std::cout << run.startTime << "," << run.seed << "," << run.ticks << "," << run.timeAlive << "," << run.score << ","
+						<< static_cast<int>(run.playerCount) << "," << static_cast<int>(run.flags) << "," << GetCauseName(run.cause) << ","
+						<< run.deathX << "," << run.deathY << "," << run.deathVelocity << "," << run.obstacleX << "," << run.gapTop << "," << run.gapBottom << ","
+						<< run.frames << "," << run.missedFrames << "," << run.frameTimeMean << "," << run.frameTimeWorst << "\n";
+					continue;
+				}
+
+				runCount++;
+				causeCounts[static_cast<int>(run.cause) < 4 ? static_cast<int>(run.cause) : 0]++;
+				totalScore += run.score;
+				bestScore = std::max(bestScore, static_cast<int>(run.score));
+				totalTime += run.timeAlive;
+				totalFrames += run.frames;
+				totalMissed += run.missedFrames;
+				totalFrameTime += static_cast<double>(run.frameTimeMean) * run.frames;
+				worstFrameTime = std::max(worstFrameTime, run.frameTimeWorst);
+			}
+		}
+
+		if (isCsv)
+		{
+			return 0;
+		}
+
+		std::cout << runCount << " runs";
+
+		if (runCount > 0)
+		{
+			std::cout << "  mean score " << static_cast<double>(totalScore) / runCount << "  best " << bestScore
+				<< "  mean time alive " << totalTime / runCount << " s\n"
+				<< "deaths: obstacle " << causeCounts[static_cast<int>(DeathCause::Obstacle)]
+				<< "  fall " << causeCounts[static_cast<int>(DeathCause::Fall)]
+				<< "  quit " << causeCounts[static_cast<int>(DeathCause::Quit)];
+		}
+
+		if (totalFrames > 0)
+		{
+			std::cout << "\nframes: " << totalFrames << "  mean " << 1000.0 * totalFrameTime / totalFrames << " ms  worst " << 1000.0f * worstFrameTime << " ms"
+				<< "  missed " << 100.0 * totalMissed / totalFrames << "%";
+		}
+
+		std::cout << "\n";
+		return 0;
+	}
+}
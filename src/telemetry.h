@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "world.h"
+
+// One record per played round, appended to a binary log by a background thread so the game never waits on the disk
+namespace Telemetry
+{
+	enum class DeathCause : uint8_t
+	{
+		None, Obstacle, Fall, Quit
+	};
+
+	namespace Flags
+	{
+		const uint8_t practice = 1 << 0;
+		const uint8_t autopilot = 1 << 1;
+		const uint8_t dailyChallenge = 1 << 2;
+	}
+
+	struct Run
+	{
+		// Seconds since the epoch when the round started
+		uint64_t startTime;
+		uint64_t seed;
+
+		uint64_t ticks;
+		float timeAlive;
+		int32_t score;
+
+		uint8_t playerCount;
+		uint8_t flags;
+		DeathCause cause;
+
+		// The bird that ended the round and the obstacle at that moment
+		float deathX;
+		float deathY;
+		float deathVelocity;
+		float obstacleX;
+		float gapTop;
+		float gapBottom;
+
+		// Frames drawn while the round was being played, times in seconds
+		uint32_t frames;
+		uint32_t missedFrames;
+		float frameTimeMean;
+		float frameTimeWorst;
+	};
+
+	// Bytes per run in the log; fields are stored little-endian in the order above, with no padding
+	const size_t recordSize = 75;
+
+	// Runs waiting for the writer; pushing into a full buffer drops the run rather than waiting
+	const int bufferCapacity = 256;
+
+	// Call right after the world is reset
+	void Begin(Run& run, const World::World& world, uint8_t flags);
+	void AddFrame(Run& run, float frameTime);
+	// Call on the tick the round was lost, while the world's events still say why
+	void SetDeath(Run& run, const World::World& world);
+	void Finish(Run& run, const World::World& world, uint32_t missedFrames);
+
+	// Appends to path, creating it if needed; false when it can't be opened or holds another format
+	bool Start(const std::string& path);
+	bool Push(const Run& run);
+	// Writes whatever is still buffered and stops the writer
+	void Stop();
+
+	unsigned long long GetDroppedCount();
+
+	// Reads a log back in blocks, so logs larger than memory can be streamed
+	struct Reader
+	{
+		std::ifstream file;
+	};
+
+	bool Open(Reader& reader, const std::string& path);
+	// Returns how many runs were read, 0 at the end of the log
+	size_t Read(Reader& reader, Run* runs, size_t maxCount);
+
+	const char* GetCauseName(DeathCause cause);
+
+	// Prints totals over a log, or every run as CSV. Returns 0, or 2 on a bad file
+	int Summarize(const std::string& path, bool isCsv);
+}
@@ -0,0 +1,939 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "agent.h"
+#include "batch.h"
+#include "difficulty_check.h"
+#include "hash_log.h"
+#include "headless.h"
+#include "heatmap.h"
+#include "netplay_test.h"
+#include "planner.h"
+#include "state_hash.h"
+#include "sweep.h"
+#include "telemetry.h"
+#include "trainer.h"
+#include "tuning.h"
+#include "video.h"
+
+namespace Tools
+{
+	static void PrintUsage();
+	static int Train(int argc, char* argv[]);
+	static int RunBatch(int argc, char* argv[]);
+	static int TestNetplay(int argc, char* argv[]);
+	static int WriteHashLog(int argc, char* argv[]);
+	static int Render(int argc, char* argv[]);
+	static int ExportVideo(int argc, char* argv[]);
+	static int DrawHeatmap(int argc, char* argv[]);
+	static int CheckDifficulty(int argc, char* argv[]);
+	static int TryAutopilot(int argc, char* argv[]);
+	static int RunSweep(int argc, char* argv[]);
+	static int HostAgent(int argc, char* argv[]);
+	static int RunAgentBot(int argc, char* argv[]);
+
+	void PrintUsage()
+	{
+		std::cout << "usage: FlappyBirdTools [--tuning PATH] <command> [options]\n"
+			"\n"
+			"  --tuning PATH   simulate with the gameplay constants in PATH instead of the defaults;\n"
+			"                  replays and hash logs only match under the tuning they were made with\n"
+			"\n"
+			"commands:\n"
+			"  train   evolve an autopilot policy\n"
+			"          --population N --generations N --episodes N --elite N --threads N\n"
+			"          --mutation-rate F --mutation-scale F --dt F --max-time F --seed N --out PATH --pin\n"
+			"  batch   simulate a batch of episodes on the job system\n"
+			"          --episodes N --chunk N --threads N --dt F --max-time F --flap-chance F\n"
+			"          --policy PATH --seed N --pin --scaling\n"
+			"  netplay-test   run two rollback peers over loopback and check they agree\n"
+			"          --ticks N --rate F --fps F --latency MS --jitter MS --loss F --delay N --port N --seed N\n"
+			"  hash-log   play scripted rounds and log the state hash of every tick\n"
+			"          --ticks N --dt F --players N --flap-chance F --seed N --out PATH --no-fields\n"
+			"  hash-diff <a> <b>   find the first tick where two hash logs disagree\n"
+			"  render   play a scripted game rendered on the CPU and time every frame\n"
+			"          --frames N --players N --threads N --tile N --seed N --out PATH\n"
+			"          --golden PATH --tolerance N --update-golden --pin\n"
+			"          with the defaults the last frame matches res/golden/render.ppm; check after changing any drawing\n"
+			"  video <replay>   render a replay offline to a Y4M stream or a PNG sequence\n"
+			"          --out PATH --png --width N --height N --fps N --tail F --threads N --encoders N --tile N --pin\n"
+			"  telemetry <log> [--csv]   summarize the runs in a telemetry log, or print them as CSV\n"
+			"  heatmap <log>   bin every death in a telemetry log into heatmaps\n"
+			"          --out PATH --bins N --scale N --block N --threads N --cause obstacle|fall|all --no-practice --pin\n"
+			"  difficulty   play the difficulty curves of the tuning and check every gap is reachable\n"
+			"          --seeds N --gaps N --dt F --seed N --threads N --pin\n"
+			"  autopilot   play rounds with the search autopilot and time its planning\n"
+			"          --rounds N --max-time F --fps N --budget MS --horizon F --dt F --seed N\n"
+			"  sweep   play a batch for every obstacle speed, gap and spacing in a grid and report\n"
+			"          survival curves and score distributions; axes take a,b,c or from:to:step\n"
+			"          --speeds LIST --gaps LIST --spacings LIST --bot random|rule|PATH --episodes N\n"
+			"          --chunk N --threads N --dt F --max-time F --flap-chance F --curve-step F --csv PATH --seed N --pin\n"
+			"  agent-host   play rounds headless for an agent in another process over shared memory\n"
+			"          --name NAME --rounds N --players N --dt F --max-time F --seed N --lockstep --timeout MS\n"
+			"  agent-bot   drive a game hosting an agent link with a simple rule, as an example agent\n"
+			"          --name NAME --idle F\n"
+			"  agent-test   check that actions answering a restarted round are dropped, over two lockstep rounds\n"
+			"          --name NAME\n";
+	}
+
+	int Train(int argc, char* argv[])
+	{
+		Trainer::Config config;
+
+		for (int i = 0; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option == "--pin")
+			{
+				config.pinThreads = true;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--population")
+			{
+				config.population = std::atoi(value);
+			}
+			else if (option == "--generations")
+			{
+				config.generations = std::atoi(value);
+			}
+			else if (option == "--episodes")
+			{
+				config.episodes = std::atoi(value);
+			}
+			else if (option == "--elite")
+			{
+				config.eliteCount = std::atoi(value);
+			}
+			else if (option == "--threads")
+			{
+				config.threadCount = std::atoi(value);
+			}
+			else if (option == "--mutation-rate")
+			{
+				config.mutationRate = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--mutation-scale")
+			{
+				config.mutationScale = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--dt")
+			{
+				config.deltaT = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--max-time")
+			{
+				config.maxTime = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--seed")
+			{
+				config.seed = std::strtoull(value, nullptr, 0);
+			}
+			else if (option == "--out")
+			{
+				config.outputPath = value;
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return Trainer::Run(config);
+	}
+
+	int RunBatch(int argc, char* argv[])
+	{
+		Batch::Config config;
+
+		for (int i = 0; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option == "--pin")
+			{
+				config.pinThreads = true;
+				continue;
+			}
+
+			if (option == "--scaling")
+			{
+				config.isScaling = true;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--episodes")
+			{
+				config.episodes = std::atoi(value);
+			}
+			else if (option == "--chunk")
+			{
+				config.chunkSize = std::atoi(value);
+			}
+			else if (option == "--threads")
+			{
+				config.threadCount = std::atoi(value);
+			}
+			else if (option == "--dt")
+			{
+				config.deltaT = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--max-time")
+			{
+				config.maxTime = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--flap-chance")
+			{
+				config.flapChance = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--policy")
+			{
+				config.policyPath = value;
+			}
+			else if (option == "--seed")
+			{
+				config.seed = std::strtoull(value, nullptr, 0);
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return Batch::Run(config);
+	}
+
+	int TestNetplay(int argc, char* argv[])
+	{
+		NetplayTest::Config config;
+
+		for (int i = 0; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--ticks")
+			{
+				config.ticks = std::atoi(value);
+			}
+			else if (option == "--rate")
+			{
+				config.tickRate = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--fps")
+			{
+				config.frameRate = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--latency")
+			{
+				config.latencyMs = std::atoi(value);
+			}
+			else if (option == "--jitter")
+			{
+				config.jitterMs = std::atoi(value);
+			}
+			else if (option == "--loss")
+			{
+				config.lossChance = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--delay")
+			{
+				config.inputDelay = std::atoi(value);
+			}
+			else if (option == "--port")
+			{
+				config.basePort = static_cast<uint16_t>(std::atoi(value));
+			}
+			else if (option == "--seed")
+			{
+				config.seed = std::strtoull(value, nullptr, 0);
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return NetplayTest::Run(config);
+	}
+
+	int WriteHashLog(int argc, char* argv[])
+	{
+		HashLog::Config config;
+
+		for (int i = 0; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option == "--no-fields")
+			{
+				config.hasFields = false;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--ticks")
+			{
+				config.ticks = std::atoi(value);
+			}
+			else if (option == "--dt")
+			{
+				config.deltaT = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--players")
+			{
+				config.playerCount = std::atoi(value);
+			}
+			else if (option == "--flap-chance")
+			{
+				config.flapChance = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--seed")
+			{
+				config.seed = std::strtoull(value, nullptr, 0);
+			}
+			else if (option == "--out")
+			{
+				config.outputPath = value;
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return HashLog::Run(config);
+	}
+
+	int Render(int argc, char* argv[])
+	{
+		Headless::Config config;
+
+		for (int i = 0; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option == "--pin")
+			{
+				config.pinThreads = true;
+				continue;
+			}
+
+			if (option == "--update-golden")
+			{
+				config.isUpdatingGolden = true;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--frames")
+			{
+				config.frames = std::atoi(value);
+			}
+			else if (option == "--players")
+			{
+				config.playerCount = std::atoi(value);
+			}
+			else if (option == "--threads")
+			{
+				config.threadCount = std::atoi(value);
+			}
+			else if (option == "--tile")
+			{
+				config.tileSize = std::atoi(value);
+			}
+			else if (option == "--seed")
+			{
+				config.seed = std::strtoull(value, nullptr, 0);
+			}
+			else if (option == "--out")
+			{
+				config.outputPath = value;
+			}
+			else if (option == "--golden")
+			{
+				config.goldenPath = value;
+			}
+			else if (option == "--tolerance")
+			{
+				config.tolerance = std::atoi(value);
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return Headless::Run(config);
+	}
+
+	int ExportVideo(int argc, char* argv[])
+	{
+		Video::Config config;
+		config.replayPath = argv[0];
+
+		for (int i = 1; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option == "--pin")
+			{
+				config.pinThreads = true;
+				continue;
+			}
+
+			if (option == "--png")
+			{
+				config.format = Video::Format::Png;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--out")
+			{
+				config.outputPath = value;
+			}
+			else if (option == "--width")
+			{
+				config.width = std::atoi(value);
+			}
+			else if (option == "--height")
+			{
+				config.height = std::atoi(value);
+			}
+			else if (option == "--fps")
+			{
+				config.fps = std::atoi(value);
+			}
+			else if (option == "--tail")
+			{
+				config.tail = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--threads")
+			{
+				config.threadCount = std::atoi(value);
+			}
+			else if (option == "--encoders")
+			{
+				config.encoderCount = std::atoi(value);
+			}
+			else if (option == "--tile")
+			{
+				config.tileSize = std::atoi(value);
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return Video::Run(config);
+	}
+
+	int DrawHeatmap(int argc, char* argv[])
+	{
+		Heatmap::Config config;
+		config.logPath = argv[0];
+
+		for (int i = 1; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option == "--pin")
+			{
+				config.pinThreads = true;
+				continue;
+			}
+
+			if (option == "--no-practice")
+			{
+				config.hasPractice = false;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			std::string value = argv[++i];
+
+			if (option == "--out")
+			{
+				config.outputPath = value;
+			}
+			else if (option == "--bins")
+			{
+				config.bins = std::atoi(value.c_str());
+			}
+			else if (option == "--scale")
+			{
+				config.scale = std::atoi(value.c_str());
+			}
+			else if (option == "--block")
+			{
+				config.blockSize = std::atoi(value.c_str());
+			}
+			else if (option == "--threads")
+			{
+				config.threadCount = std::atoi(value.c_str());
+			}
+			else if (option == "--cause" && (value == "obstacle" || value == "fall" || value == "all"))
+			{
+				config.hasObstacleDeaths = value != "fall";
+				config.hasFallDeaths = value != "obstacle";
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return Heatmap::Run(config);
+	}
+
+	int CheckDifficulty(int argc, char* argv[])
+	{
+		DifficultyCheck::Config config;
+
+		for (int i = 0; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option == "--pin")
+			{
+				config.pinThreads = true;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--seeds")
+			{
+				config.seeds = std::atoi(value);
+			}
+			else if (option == "--gaps")
+			{
+				config.gaps = std::atoi(value);
+			}
+			else if (option == "--dt")
+			{
+				config.deltaT = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--seed")
+			{
+				config.seed = std::strtoull(value, nullptr, 0);
+			}
+			else if (option == "--threads")
+			{
+				config.threadCount = std::atoi(value);
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return DifficultyCheck::Run(config);
+	}
+
+	int TryAutopilot(int argc, char* argv[])
+	{
+		Planner::TrialConfig config;
+
+		for (int i = 0; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--rounds")
+			{
+				config.rounds = std::atoi(value);
+			}
+			else if (option == "--max-time")
+			{
+				config.maxTime = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--fps")
+			{
+				config.frameRate = std::atoi(value);
+			}
+			else if (option == "--budget")
+			{
+				config.planner.budgetMs = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--horizon")
+			{
+				config.planner.horizonSeconds = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--dt")
+			{
+				config.deltaT = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--seed")
+			{
+				config.seed = std::strtoull(value, nullptr, 0);
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return Planner::RunTrials(config);
+	}
+
+	int RunSweep(int argc, char* argv[])
+	{
+		Sweep::Config config;
+
+		for (int i = 0; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option == "--pin")
+			{
+				config.pinThreads = true;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--speeds" || option == "--gaps" || option == "--spacings")
+			{
+				std::vector<float>& values = option == "--speeds" ? config.velocities : option == "--gaps" ? config.gaps : config.spacings;
+
+				if (!Sweep::ParseValues(values, value))
+				{
+					std::cerr << "bad values for " << option << ": " << value << "\n";
+					return 1;
+				}
+			}
+			else if (option == "--bot")
+			{
+				std::string bot = value;
+
+				config.bot = bot == "random" ? Sweep::Bot::Random : bot == "rule" ? Sweep::Bot::Rule : Sweep::Bot::Policy;
+				config.policyPath = bot;
+			}
+			else if (option == "--episodes")
+			{
+				config.episodes = std::atoi(value);
+			}
+			else if (option == "--chunk")
+			{
+				config.chunkSize = std::atoi(value);
+			}
+			else if (option == "--threads")
+			{
+				config.threadCount = std::atoi(value);
+			}
+			else if (option == "--dt")
+			{
+				config.deltaT = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--max-time")
+			{
+				config.maxTime = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--flap-chance")
+			{
+				config.flapChance = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--curve-step")
+			{
+				config.curveStep = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--csv")
+			{
+				config.csvPath = value;
+			}
+			else if (option == "--seed")
+			{
+				config.seed = std::strtoull(value, nullptr, 0);
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return Sweep::Run(config);
+	}
+
+	int HostAgent(int argc, char* argv[])
+	{
+		Agent::HostConfig config;
+
+		for (int i = 0; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option == "--lockstep")
+			{
+				config.isLockstep = true;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--name")
+			{
+				config.name = value;
+			}
+			else if (option == "--rounds")
+			{
+				config.rounds = std::atoi(value);
+			}
+			else if (option == "--players")
+			{
+				config.playerCount = std::atoi(value);
+			}
+			else if (option == "--dt")
+			{
+				config.deltaT = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--max-time")
+			{
+				config.maxTime = static_cast<float>(std::atof(value));
+			}
+			else if (option == "--seed")
+			{
+				config.seed = std::strtoull(value, nullptr, 0);
+			}
+			else if (option == "--timeout")
+			{
+				config.timeoutMs = static_cast<float>(std::atof(value));
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return Agent::RunHost(config);
+	}
+
+	int RunAgentBot(int argc, char* argv[])
+	{
+		Agent::BotConfig config;
+
+		for (int i = 0; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "missing value for " << option << "\n";
+				return 1;
+			}
+
+			const char* value = argv[++i];
+
+			if (option == "--name")
+			{
+				config.name = value;
+			}
+			else if (option == "--idle")
+			{
+				config.idleSeconds = static_cast<float>(std::atof(value));
+			}
+			else
+			{
+				std::cerr << "unknown option " << option << "\n";
+				return 1;
+			}
+		}
+
+		return Agent::RunBot(config);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc >= 3 && std::string(argv[1]) == "--tuning")
+	{
+		Tuning::Tuning tuning;
+
+		if (!Tuning::Load(tuning, argv[2]))
+		{
+			std::cerr << "could not read tuning " << argv[2] << "\n";
+			return 1;
+		}
+
+		Tuning::Set(tuning);
+
+		argc -= 2;
+		argv += 2;
+	}
+
+	if (argc < 2)
+	{
+		Tools::PrintUsage();
+		return 1;
+	}
+
+	std::string command = argv[1];
+
+	if (command == "train")
+	{
+		return Tools::Train(argc - 2, argv + 2);
+	}
+
+	if (command == "batch")
+	{
+		return Tools::RunBatch(argc - 2, argv + 2);
+	}
+
+	if (command == "netplay-test")
+	{
+		return Tools::TestNetplay(argc - 2, argv + 2);
+	}
+
+	if (command == "hash-log")
+	{
+		return Tools::WriteHashLog(argc - 2, argv + 2);
+	}
+
+	if (command == "render")
+	{
+		return Tools::Render(argc - 2, argv + 2);
+	}
+
+	if (command == "video" && argc >= 3)
+	{
+		return Tools::ExportVideo(argc - 2, argv + 2);
+	}
+
+	if (command == "heatmap" && argc >= 3)
+	{
+		return Tools::DrawHeatmap(argc - 2, argv + 2);
+	}
+
+	if (command == "difficulty")
+	{
+		return Tools::CheckDifficulty(argc - 2, argv + 2);
+	}
+
+	if (command == "autopilot")
+	{
+		return Tools::TryAutopilot(argc - 2, argv + 2);
+	}
+
+	if (command == "sweep")
+	{
+		return Tools::RunSweep(argc - 2, argv + 2);
+	}
+
+	if (command == "agent-host")
+	{
+		return Tools::HostAgent(argc - 2, argv + 2);
+	}
+
+	if (command == "agent-bot")
+	{
+		return Tools::RunAgentBot(argc - 2, argv + 2);
+	}
+
+	if (command == "agent-test" && (argc == 2 || (argc == 4 && std::string(argv[2]) == "--name")))
+	{
+		return Agent::RunCheck(argc == 4 ? argv[3] : "flappy-test");
+	}
+
+	if (command == "telemetry" && (argc == 3 || (argc == 4 && std::string(argv[3]) == "--csv")))
+	{
+		return Telemetry::Summarize(argv[2], argc == 4);
+	}
+
+	if (command == "hash-diff" && argc == 4)
+	{
+		return StateHash::Diff(argv[2], argv[3]);
+	}
+
+	Tools::PrintUsage();
+	return 1;
+}
@@ -0,0 +1,169 @@
+#include "trainer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "job_system.h"
+#include "policy.h"
+#include "world.h"
+
+namespace Trainer
+{
+	struct Individual
+	{
+		Policy::Network network;
+		float fitness;
+	};
+
+	static float Evaluate(const Config& config, const Policy::Network& network, const std::vector<uint64_t>& seeds);
+	static void EvaluatePopulation(const Config& config, std::vector<Individual>& population, const std::vector<uint64_t>& seeds);
+	static const Individual& Tournament(const std::vector<Individual>& population, Rng::Rng& rng);
+
+	float Evaluate(const Config& config, const Policy::Network& network, const std::vector<uint64_t>& seeds)
+	{
+		float fitness = 0.0f;
+
+		for (uint64_t seed : seeds)
+		{
+			World::World world;
+			World::Reset(world, 1, seed);
+			world.deltaT = config.deltaT;
+
+			while (!world.hasLost && world.timeAlive < config.maxTime)
+			{
+				World::Observation observation = World::Observe(world.birds[0], world.obstacle);
+				World::Step<1>(world, Policy::Evaluate(network, observation) ? 1 : 0);
+			}
+
+			// Score first, time alive only breaks ties between equal scores
+			fitness += static_cast<float>(world.score) + world.timeAlive / (config.maxTime + 1.0f);
+		}
+
+		return fitness / static_cast<float>(seeds.size());
+	}
+
+	void EvaluatePopulation(const Config& config, std::vector<Individual>& population, const std::vector<uint64_t>& seeds)
+	{
+		// One individual per chunk: their episodes end at random times, stealing keeps every worker busy
+		Jobs::ParallelFor(static_cast<int>(population.size()), 1, [&](int begin, int end, int)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				population[i].fitness = Evaluate(config, population[i].network, seeds);
+			}
+		});
+	}
+
+	const Individual& Tournament(const std::vector<Individual>& population, Rng::Rng& rng)
+	{
+		const int size = static_cast<int>(population.size()) - 1;
+
+		const Individual& first = population[Rng::Range(rng, 0, size)];
+		const Individual& second = population[Rng::Range(rng, 0, size)];
+
+		return first.fitness >= second.fitness ? first : second;
+	}
+
+	int Run(const Config& config)
+	{
+		if (config.population < 2 || config.episodes < 1)
+		{
+			std::cerr << "population must be at least 2 and episodes at least 1\n";
+			return 1;
+		}
+
+		if (config.eliteCount < 1 || config.eliteCount > config.population)
+		{
+			std::cerr << "elite must be between 1 and the population\n";
+			return 1;
+		}
+
+		Jobs::Initialize(config.threadCount, config.pinThreads);
+
+		Rng::Rng rng;
+		Rng::Seed(rng, config.seed);
+
+		std::vector<Individual> population(config.population);
+
+		for (Individual& individual : population)
+		{
+			Policy::Randomize(individual.network, rng, 1.0f);
+			individual.fitness = 0.0f;
+		}
+
+		std::vector<uint64_t> seeds(config.episodes);
+		Individual champion = population[0];
+		champion.fitness = -1.0f;
+
+		auto start = std::chrono::steady_clock::now();
+
+		for (int generation = 0; generation < config.generations; generation++)
+		{
+			// Every individual of a generation plays the same levels so fitness is comparable
+			for (uint64_t& seed : seeds)
+			{
+				seed = (static_cast<uint64_t>(Rng::Next(rng)) << 32) | Rng::Next(rng);
+			}
+
+			EvaluatePopulation(config, population, seeds);
+
+			std::sort(population.begin(), population.end(), [](const Individual& a, const Individual& b)
+			{
+				return a.fitness > b.fitness;
+			});
+
+			// The incumbent's fitness came from other levels; an early network that drew easy ones would otherwise stay
+			// champion over better later ones
+			if (generation > 0)
+			{
+				champion.fitness = Evaluate(config, champion.network, seeds);
+			}
+
+			if (population[0].fitness > champion.fitness)
+			{
+				champion = population[0];
+			}
+
+			float meanFitness = 0.0f;
+
+			for (const Individual& individual : population)
+			{
+				meanFitness += individual.fitness;
+			}
+
+			meanFitness /= static_cast<float>(population.size());
+
+			double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			std::cout << "generation " << generation + 1 << "/" << config.generations
+				<< "  best " << population[0].fitness
+				<< "  mean " << meanFitness
+				<< "  champion " << champion.fitness
+				<< "  " << (generation + 1) / elapsed << " gen/s\n";
+
+			std::vector<Individual> nextPopulation(population.begin(), population.begin() + config.eliteCount);
+
+			while (static_cast<int>(nextPopulation.size()) < config.population)
+			{
+				Individual child = Tournament(population, rng);
+				Policy::Mutate(child.network, rng, config.mutationRate, config.mutationScale);
+				nextPopulation.push_back(child);
+			}
+
+			population.swap(nextPopulation);
+		}
+
+		Jobs::Shutdown();
+
+		if (!Policy::Save(champion.network, config.outputPath))
+		{
+			std::cerr << "could not write " << config.outputPath << "\n";
+			return 1;
+		}
+
+		std::cout << "champion (fitness " << champion.fitness << ") written to " << config.outputPath << "\n";
+		return 0;
+	}
+}
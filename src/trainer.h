@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "world.h"
+
+namespace Trainer
+{
+	struct Config
+	{
+		int population = 256;
+		int generations = 100;
+		int episodes = 8;
+		int eliteCount = 8;
+		int threadCount = 0;
+		bool pinThreads = false;
+
+		float mutationRate = 0.2f;
+		float mutationScale = 0.3f;
+
+		float deltaT = World::defaultDeltaT;
+		float maxTime = 120.0f;
+
+		uint64_t seed = 1;
+
+		// Where the game loads its champion from, Externs::championPolicy
+		std::string outputPath = "res/bots/champion.policy";
+	};
+
+	int Run(const Config& config);
+}
@@ -0,0 +1,502 @@
+#include "tuning.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Tuning
+{
+	struct Field
+	{
+		const char* name;
+		float Tuning::* value;
+
+		// Values below this are rejected, as is anything that is not a number
+		float minimum;
+	};
+
+	struct CurveField
+	{
+		const char* name;
+		Curve Tuning::* curve;
+
+		// Points below this are rejected, like the value the curve stands in for
+		float minimum;
+	};
+
+	// The binary image is this memory as is; it only has to be read back on the machine that wrote it
+	struct Cache
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t tuningSize;
+
+		// Of the text the values were parsed from
+		uint64_t sourceHash;
+		// Over the source hash and the values
+		uint64_t checksum;
+
+		Tuning tuning;
+	};
+
+	namespace Variables
+	{
+		const char* fileHeader = "flappy-tuning";
+		const int fileVersion = 1;
+
+		const char cacheMagic[8] = { 'F', 'L', 'A', 'P', 'T', 'U', 'N', 'E' };
+		const uint32_t cacheVersion = 2;
+
+		static const Field fields[] =
+		{
+			{ "gravity", &Tuning::gravity, std::numeric_limits<float>::lowest() },
+			{ "flap-velocity", &Tuning::flapVelocity, 0.0f },
+			{ "bird-radius", &Tuning::birdRadius, 1.0f },
+			{ "obstacle-velocity", &Tuning::obstacleVelocity, 1.0f },
+			{ "obstacle-width", &Tuning::obstacleWidth, 1.0f },
+			{ "gap-space", &Tuning::gapSpace, 1.0f },
+			{ "gap-margin", &Tuning::gapMargin, 0.0f },
+			{ "obstacle-spacing", &Tuning::obstacleSpacing, 0.0f }
+		};
+
+		static const CurveField curveFields[] =
+		{
+			{ "obstacle-velocity-curve", &Tuning::obstacleVelocityCurve, 1.0f },
+			{ "gap-space-curve", &Tuning::gapSpaceCurve, 1.0f },
+			{ "obstacle-spacing-curve", &Tuning::obstacleSpacingCurve, 0.0f }
+		};
+
+		static Tuning current;
+		// What Get returns on this thread; one load and no branch, since the simulation calls it all the time
+		static thread_local const Tuning* active = &current;
+
+		static std::string watchedPath;
+		static std::string watchedCachePath;
+
+#if defined(_WIN32)
+		static HANDLE notification = INVALID_HANDLE_VALUE;
+#elif defined(__linux__)
+		static int descriptor = -1;
+		static std::string watchedName;
+#endif
+	}
+
+	static const Field* FindField(const std::string& name);
+	static const CurveField* FindCurveField(const std::string& name);
+	static bool ReadCurve(std::istringstream& words, Curve& curve, float minimum);
+	static bool IsValid(const Curve& curve, float minimum);
+	static uint64_t Hash(uint64_t hash, const void* data, size_t size);
+	static bool HashFile(const std::string& path, uint64_t& hash);
+	static uint64_t GetChecksum(const Cache& cache);
+	static bool HasChanged();
+	static void SplitPath(const std::string& path, std::string& directory, std::string& name);
+
+	const Field* FindField(const std::string& name)
+	{
+		for (const Field& field : Variables::fields)
+		{
+			if (name == field.name)
+			{
+				return &field;
+			}
+		}
+
+		return nullptr;
+	}
+
+	const CurveField* FindCurveField(const std::string& name)
+	{
+		for (const CurveField& field : Variables::curveFields)
+		{
+			if (name == field.name)
+			{
+				return &field;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool ReadCurve(std::istringstream& words, Curve& curve, float minimum)
+	{
+		std::string axis;
+
+		if (!(words >> axis) || (axis != "score" && axis != "time"))
+		{
+			return false;
+		}
+
+		curve = Curve();
+		curve.axis = axis == "score" ? CurveAxis::Score : CurveAxis::Time;
+
+		CurvePoint point;
+
+		while (words >> point.at)
+		{
+			if (curve.pointCount == maxCurvePoints || !(words >> point.value))
+			{
+				return false;
+			}
+
+			curve.points[curve.pointCount++] = point;
+		}
+
+		// Stopped by something that is not a number rather than the end of the line
+		if (!words.eof())
+		{
+			return false;
+		}
+
+		return IsValid(curve, minimum);
+	}
+
+	bool IsValid(const Curve& curve, float minimum)
+	{
+		if ((curve.axis != CurveAxis::Score && curve.axis != CurveAxis::Time) || curve.pointCount < 0 || curve.pointCount > maxCurvePoints)
+		{
+			return false;
+		}
+
+		for (int i = 0; i < curve.pointCount; i++)
+		{
+			const CurvePoint& point = curve.points[i];
+
+			if (!(point.value >= minimum) || !(point.at >= std::numeric_limits<float>::lowest()) || (i > 0 && !(point.at > curve.points[i - 1].at)))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool IsValid(const Tuning& tuning)
+	{
+		for (const Field& field : Variables::fields)
+		{
+			if (!(tuning.*field.value >= field.minimum))
+			{
+				return false;
+			}
+		}
+
+		for (const CurveField& field : Variables::curveFields)
+		{
+			if (!IsValid(tuning.*field.curve, field.minimum))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	uint64_t Hash(uint64_t hash, const void* data, size_t size)
+	{
+		// FNV-1a
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	bool HashFile(const std::string& path, uint64_t& hash)
+	{
+		std::ifstream file(path, std::ios::binary);
+
+		if (!file)
+		{
+			return false;
+		}
+
+		char buffer[4096];
+		hash = 0xCBF29CE484222325ull;
+
+		while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+		{
+			hash = Hash(hash, buffer, static_cast<size_t>(file.gcount()));
+		}
+
+		return file.eof();
+	}
+
+	uint64_t GetChecksum(const Cache& cache)
+	{
+		return Hash(Hash(0xCBF29CE484222325ull, &cache.sourceHash, sizeof(cache.sourceHash)), &cache.tuning, sizeof(cache.tuning));
+	}
+
+	void SplitPath(const std::string& path, std::string& directory, std::string& name)
+	{
+		size_t slash = path.find_last_of("/\\");
+
+		directory = slash == std::string::npos ? "." : path.substr(0, slash);
+		name = slash == std::string::npos ? path : path.substr(slash + 1);
+	}
+
+	const Tuning& Get()
+	{
+		return *Variables::active;
+	}
+
+	void Set(const Tuning& tuning)
+	{
+		Variables::current = tuning;
+	}
+
+	void SetOverride(const Tuning* tuning)
+	{
+		Variables::active = tuning != nullptr ? tuning : &Variables::current;
+	}
+
+	bool Load(Tuning& tuning, const std::string& path)
+	{
+		std::ifstream file(path);
+
+		std::string header;
+		int version = 0;
+
+		if (!(file >> header >> version) || header != Variables::fileHeader || version != Variables::fileVersion)
+		{
+			return false;
+		}
+
+		Tuning loaded;
+		std::string line;
+		int lineNumber = 1;
+
+		while (std::getline(file, line))
+		{
+			// Blank lines and # comments are for the designers
+			std::istringstream words(line.substr(0, line.find('#')));
+			std::string name;
+			std::string extra;
+			float value = 0.0f;
+
+			if (!(words >> name))
+			{
+				lineNumber++;
+				continue;
+			}
+
+			const CurveField* curveField = FindCurveField(name);
+
+			if (curveField != nullptr)
+			{
+				if (!ReadCurve(words, loaded.*curveField->curve, curveField->minimum))
+				{
+					std::cerr << path << ":" << lineNumber << ": bad curve " << name << ", expected score or time then up to " << maxCurvePoints << " pairs of increasing at and value\n";
+					return false;
+				}
+
+				lineNumber++;
+				continue;
+			}
+
+			const Field* field = FindField(name);
+
+			if (field == nullptr || !(words >> value) || (words >> extra) || !(value >= field->minimum))
+			{
+				std::cerr << path << ":" << lineNumber << ": " << (field == nullptr ? "unknown setting " : "bad value for ") << name << "\n";
+				return false;
+			}
+
+			loaded.*field->value = value;
+			lineNumber++;
+		}
+
+		tuning = loaded;
+		return true;
+	}
+
+	bool LoadCached(Tuning& tuning, const std::string& path, const std::string& cachePath)
+	{
+		uint64_t sourceHash = 0;
+
+		if (cachePath.empty() || !HashFile(path, sourceHash))
+		{
+			return Load(tuning, path);
+		}
+
+		Cache cache;
+		std::ifstream cacheFile(cachePath, std::ios::binary);
+
+		bool isCurrent = cacheFile.read(reinterpret_cast<char*>(&cache), sizeof(cache))
+			&& std::memcmp(cache.magic, Variables::cacheMagic, sizeof(cache.magic)) == 0
+			&& cache.version == Variables::cacheVersion
+			&& cache.tuningSize == sizeof(Tuning)
+			&& cache.sourceHash == sourceHash
+			&& cache.checksum == GetChecksum(cache)
+			&& IsValid(cache.tuning);
+
+		cacheFile.close();
+
+		if (isCurrent)
+		{
+			tuning = cache.tuning;
+			return true;
+		}
+
+		Tuning loaded;
+
+		if (!Load(loaded, path))
+		{
+			return false;
+		}
+
+		std::memcpy(cache.magic, Variables::cacheMagic, sizeof(cache.magic));
+		cache.version = Variables::cacheVersion;
+		cache.tuningSize = sizeof(Tuning);
+		cache.sourceHash = sourceHash;
+		cache.tuning = loaded;
+		cache.checksum = GetChecksum(cache);
+
+		// Not being able to write it only costs the next start a parse
+		std::ofstream(cachePath, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char*>(&cache), sizeof(cache));
+
+		tuning = loaded;
+		return true;
+	}
+
+	bool Watch(const std::string& path, const std::string& cachePath)
+	{
+		Unwatch();
+
+		Tuning loaded;
+
+		if (!LoadCached(loaded, path, cachePath))
+		{
+			return false;
+		}
+
+		Set(loaded);
+		Variables::watchedPath = path;
+		Variables::watchedCachePath = cachePath;
+
+		std::string directory;
+		std::string name;
+		SplitPath(path, directory, name);
+
+		// Editors often save by writing a new file and renaming it over the old one, so the directory is watched
+#if defined(_WIN32)
+		Variables::notification = FindFirstChangeNotificationA(directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+#elif defined(__linux__)
+		Variables::descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		Variables::watchedName = name;
+
+		if (Variables::descriptor >= 0 && inotify_add_watch(Variables::descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+		{
+			close(Variables::descriptor);
+			Variables::descriptor = -1;
+		}
+#endif
+
+		return true;
+	}
+
+	bool HasChanged()
+	{
+#if defined(_WIN32)
+		if (Variables::notification == INVALID_HANDLE_VALUE || WaitForSingleObject(Variables::notification, 0) != WAIT_OBJECT_0)
+		{
+			return false;
+		}
+
+		// Anything in the directory sets it off; Poll compares the values to tell if the file was it
+		FindNextChangeNotification(Variables::notification);
+		return true;
+#elif defined(__linux__)
+		if (Variables::descriptor < 0)
+		{
+			return false;
+		}
+
+		alignas(inotify_event) char buffer[4096];
+		bool isChanged = false;
+		ssize_t size = 0;
+
+		while ((size = read(Variables::descriptor, buffer, sizeof(buffer))) > 0)
+		{
+			for (ssize_t offset = 0; offset < size;)
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+
+				if (event->len > 0 && Variables::watchedName == event->name)
+				{
+					isChanged = true;
+				}
+
+				offset += sizeof(inotify_event) + event->len;
+			}
+		}
+
+		return isChanged;
+#else
+		return false;
+#endif
+	}
+
+	bool Poll()
+	{
+		if (!HasChanged())
+		{
+			return false;
+		}
+
+		Tuning loaded;
+
+		// A half written file fails to parse; the write that completes it notifies again
+		if (!LoadCached(loaded, Variables::watchedPath, Variables::watchedCachePath))
+		{
+			std::cerr << "could not reload " << Variables::watchedPath << ", keeping the current tuning\n";
+			return false;
+		}
+
+		if (std::memcmp(&loaded, &Variables::current, sizeof(Tuning)) == 0)
+		{
+			return false;
+		}
+
+		Set(loaded);
+		std::cout << "reloaded " << Variables::watchedPath << "\n";
+
+		return true;
+	}
+
+	void Unwatch()
+	{
+#if defined(_WIN32)
+		if (Variables::notification != INVALID_HANDLE_VALUE)
+		{
+			FindCloseChangeNotification(Variables::notification);
+		}
+
+		Variables::notification = INVALID_HANDLE_VALUE;
+#elif defined(__linux__)
+		if (Variables::descriptor >= 0)
+		{
+			close(Variables::descriptor);
+		}
+
+		Variables::descriptor = -1;
+#endif
+
+		Variables::watchedPath.clear();
+		Variables::watchedCachePath.clear();
+	}
+}
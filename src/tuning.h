@@ -0,0 +1,81 @@
+#pragma once
+#include <string>
+
+// Gameplay constants in one place. The game reads them from a text file and picks up edits to it while running.
+// Kept free of raylib so the platform file watching headers can be included
+namespace Tuning
+{
+	enum class CurveAxis : int
+	{
+		Score, Time
+	};
+
+	const int maxCurvePoints = 8;
+
+	struct CurvePoint
+	{
+		float at;
+		float value;
+	};
+
+	// Piecewise linear over the score or the seconds alive, flat past both ends. Points are in increasing order of at;
+	// a curve without points leaves the plain value in charge
+	struct Curve
+	{
+		CurveAxis axis;
+		int pointCount;
+
+		CurvePoint points[maxCurvePoints];
+	};
+
+	// Flat so a reload swaps every value at once
+	struct Tuning
+	{
+		// Pulls the bird down, in pixels per second squared
+		float gravity = 981.0f;
+
+		// Upwards speed a flap sets
+		float flapVelocity = 500.0f;
+		float birdRadius = 30.0f;
+
+		// Changes to the speed apply at once; the rest only reach new obstacles, the one on screen keeps its own
+		float obstacleVelocity = 500.0f;
+		float obstacleWidth = 50.0f;
+
+		// Height of the gap between the pipes, and the least room it leaves to the screen's edges
+		float gapSpace = 200.0f;
+		float gapMargin = 15.0f;
+
+		// How far past the right edge of the screen a new obstacle starts
+		float obstacleSpacing = 0.0f;
+
+		// The difficulty schedule, see Difficulty
+		Curve obstacleVelocityCurve = {};
+		Curve gapSpaceCurve = {};
+		Curve obstacleSpacingCurve = {};
+	};
+
+	// What the simulation reads. Set and Poll only run between ticks, so a tick never sees half of a change
+	const Tuning& Get();
+	void Set(const Tuning& tuning);
+
+	// Per thread: while set, Get on this thread returns tuning instead of the shared values, so simulations with their
+	// own tunings can run side by side. nullptr goes back to the shared ones; the caller keeps tuning alive until then
+	void SetOverride(const Tuning* tuning);
+
+	// Whether every value is in the range the file parser accepts; for tunings read from elsewhere
+	bool IsValid(const Tuning& tuning);
+
+	// Values the file leaves out keep their defaults. Prints the first bad line and changes nothing on errors
+	bool Load(Tuning& tuning, const std::string& path);
+
+	// Same as Load, but the text is only parsed when its hash differs from the one the binary image at cachePath was
+	// made from. A valid image is copied straight in; a parse rewrites it. An empty cachePath always parses
+	bool LoadCached(Tuning& tuning, const std::string& path, const std::string& cachePath);
+
+	// Loads the file through the cache, then watches it for changes
+	bool Watch(const std::string& path, const std::string& cachePath);
+	// Reloads the watched file if it changed since the last call; returns whether new values were applied
+	bool Poll();
+	void Unwatch();
+}
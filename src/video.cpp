@@ -0,0 +1,402 @@
+#include "video.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "raylib.h"
+
+#include "headless.h"
+#include "job_system.h"
+#include "replay.h"
+#include "state_hash.h"
+
+namespace Video
+{
+	enum class SlotState
+	{
+		Free, Rendered, Encoded
+	};
+
+	// One frame on its way through the pipeline; frame n always uses slot n % slotCount
+	struct Slot
+	{
+		SlotState state = SlotState::Free;
+		int frame = 0;
+
+		SoftRender::Framebuffer framebuffer;
+		std::vector<uint8_t> encoded;
+	};
+
+	struct Pipeline
+	{
+		std::mutex mutex;
+		std::condition_variable changed;
+
+		std::vector<Slot> slots;
+
+		// Rendered slots waiting for an encoder, oldest first
+		std::deque<int> queue;
+
+		// Set by the main thread once it rendered its last frame
+		bool isDone = false;
+		int frameCount = 0;
+
+		bool hasFailed = false;
+	};
+
+	static void EncodeY4m(const SoftRender::Framebuffer& framebuffer, std::vector<uint8_t>& encoded);
+	static bool EncodePng(const SoftRender::Framebuffer& framebuffer, std::vector<uint8_t>& encoded);
+	static std::string GetPngPath(const Config& config, int frame);
+
+	static void Encode(const Config& config, Pipeline& pipeline);
+	static void Write(const Config& config, Pipeline& pipeline);
+
+	void EncodeY4m(const SoftRender::Framebuffer& framebuffer, std::vector<uint8_t>& encoded)
+	{
+		const int width = framebuffer.width;
+		const int height = framebuffer.height;
+		const size_t lumaSize = static_cast<size_t>(width) * height;
+		const size_t chromaSize = lumaSize / 4;
+
+		const std::string marker = "FRAME\n";
+
+		encoded.resize(marker.size() + lumaSize + chromaSize * 2);
+		std::copy(marker.begin(), marker.end(), encoded.begin());
+
+		uint8_t* luma = encoded.data() + marker.size();
+		uint8_t* blue = luma + lumaSize;
+		uint8_t* red = blue + chromaSize;
+
+		// BT.601 studio range, what players assume when a stream does not say; offsets keep the shifts on positive numbers
+		for (size_t i = 0; i < lumaSize; i++)
+		{
+			uint32_t pixel = framebuffer.pixels[i];
+			int r = pixel & 0xFF;
+			int g = (pixel >> 8) & 0xFF;
+			int b = (pixel >> 16) & 0xFF;
+
+			luma[i] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+		}
+
+		// Chroma from the average of each 2x2 block
+		for (int y = 0; y < height; y += 2)
+		{
+			const uint32_t* top = framebuffer.pixels.data() + static_cast<size_t>(y) * width;
+			const uint32_t* bottom = top + width;
+
+			for (int x = 0; x < width; x += 2)
+			{
+				int r = 0;
+				int g = 0;
+				int b = 0;
+
+				for (uint32_t pixel : { top[x], top[x + 1], bottom[x], bottom[x + 1] })
+				{
+					r += pixel & 0xFF;
+					g += (pixel >> 8) & 0xFF;
+					b += (pixel >> 16) & 0xFF;
+				}
+
+				r = (r + 2) >> 2;
+				g = (g + 2) >> 2;
+				b = (b + 2) >> 2;
+
+				size_t index = static_cast<size_t>(y / 2) * (width / 2) + x / 2;
+
+				blue[index] = static_cast<uint8_t>((-38 * r - 74 * g + 112 * b + 128 + (128 << 8)) >> 8);
+				red[index] = static_cast<uint8_t>((112 * r - 94 * g - 18 * b + 128 + (128 << 8)) >> 8);
+			}
+		}
+	}
+
+	bool EncodePng(const SoftRender::Framebuffer& framebuffer, std::vector<uint8_t>& encoded)
+	{
+		// Alpha is always opaque here, dropping it makes the files smaller and the compression quicker
+		std::vector<uint8_t> rgb(static_cast<size_t>(framebuffer.width) * framebuffer.height * 3);
+
+		for (size_t i = 0; i < framebuffer.pixels.size(); i++)
+		{
+			uint32_t pixel = framebuffer.pixels[i];
+
+			rgb[i * 3] = static_cast<uint8_t>(pixel);
+			rgb[i * 3 + 1] = static_cast<uint8_t>(pixel >> 8);
+			rgb[i * 3 + 2] = static_cast<uint8_t>(pixel >> 16);
+		}
+
+		Image image = { rgb.data(), framebuffer.width, framebuffer.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8 };
+
+		int size = 0;
+		unsigned char* data = ExportImageToMemory(image, ".png", &size);
+
+		if (data == nullptr)
+		{
+			return false;
+		}
+
+		encoded.assign(data, data + size);
+		MemFree(data);
+
+		return true;
+	}
+
+	std::string GetPngPath(const Config& config, int frame)
+	{
+		std::ostringstream path;
+		path << config.outputPath << std::setw(5) << std::setfill('0') << frame << ".png";
+
+		return path.str();
+	}
+
+	void Encode(const Config& config, Pipeline& pipeline)
+	{
+		std::unique_lock<std::mutex> lock(pipeline.mutex);
+
+		while (true)
+		{
+			pipeline.changed.wait(lock, [&]() { return !pipeline.queue.empty() || pipeline.isDone || pipeline.hasFailed; });
+
+			if (pipeline.queue.empty() || pipeline.hasFailed)
+			{
+				return;
+			}
+
+			Slot& slot = pipeline.slots[pipeline.queue.front()];
+			pipeline.queue.pop_front();
+
+			lock.unlock();
+
+			bool isEncoded = true;
+
+			if (config.format == Format::Y4m)
+			{
+				EncodeY4m(slot.framebuffer, slot.encoded);
+			}
+			else
+			{
+				isEncoded = EncodePng(slot.framebuffer, slot.encoded);
+			}
+
+			lock.lock();
+
+			if (!isEncoded)
+			{
+				std::cerr << "could not encode frame " << slot.frame << "\n";
+				pipeline.hasFailed = true;
+			}
+
+			slot.state = SlotState::Encoded;
+			pipeline.changed.notify_all();
+		}
+	}
+
+	void Write(const Config& config, Pipeline& pipeline)
+	{
+		std::ofstream stream;
+
+		if (config.format == Format::Y4m)
+		{
+			stream.open(config.outputPath, std::ios::binary);
+			stream << "YUV4MPEG2 W" << config.width << " H" << config.height << " F" << config.fps << ":1 Ip A1:1 C420jpeg\n";
+		}
+
+		const int slotCount = static_cast<int>(pipeline.slots.size());
+
+		std::unique_lock<std::mutex> lock(pipeline.mutex);
+
+		if (config.format == Format::Y4m && !stream)
+		{
+			std::cerr << "could not write " << config.outputPath << "\n";
+			pipeline.hasFailed = true;
+			pipeline.changed.notify_all();
+			return;
+		}
+
+		for (int frame = 0; ; frame++)
+		{
+			Slot& slot = pipeline.slots[frame % slotCount];
+
+			pipeline.changed.wait(lock, [&]()
+			{
+				return (slot.state == SlotState::Encoded && slot.frame == frame) || (pipeline.isDone && frame == pipeline.frameCount) || pipeline.hasFailed;
+			});
+
+			if (pipeline.hasFailed || slot.state != SlotState::Encoded || slot.frame != frame)
+			{
+				return;
+			}
+
+			lock.unlock();
+
+			bool isWritten;
+
+			if (config.format == Format::Y4m)
+			{
+				stream.write(reinterpret_cast<const char*>(slot.encoded.data()), static_cast<std::streamsize>(slot.encoded.size()));
+				isWritten = static_cast<bool>(stream);
+			}
+			else
+			{
+				std::ofstream file(GetPngPath(config, frame), std::ios::binary);
+				file.write(reinterpret_cast<const char*>(slot.encoded.data()), static_cast<std::streamsize>(slot.encoded.size()));
+				isWritten = static_cast<bool>(file);
+			}
+
+			lock.lock();
+
+			if (!isWritten)
+			{
+				std::cerr << "could not write frame " << frame << "\n";
+				pipeline.hasFailed = true;
+			}
+
+			slot.state = SlotState::Free;
+			pipeline.changed.notify_all();
+		}
+	}
+
+	int Run(const Config& config)
+	{
+		if (config.width <= 0 || config.height <= 0 || config.fps <= 0 || config.encoderCount < 1)
+		{
+			std::cerr << "width, height, fps and encoders must be positive\n";
+			return 1;
+		}
+
+		if (config.format == Format::Y4m && (config.width % 2 != 0 || config.height % 2 != 0))
+		{
+			std::cerr << "y4m needs an even width and height\n";
+			return 1;
+		}
+
+		Replay::Replay replay;
+
+		if (!Replay::Load(replay, config.replayPath))
+		{
+			std::cerr << "could not read replay " << config.replayPath << "\n";
+			return 1;
+		}
+
+		Jobs::Initialize(config.threadCount, config.pinThreads);
+		Parallax::Load();
+
+		World::World world;
+		Replay::Restart(replay, world);
+		World::StepFunction step = World::GetStep(world.playerCount);
+
+		Parallax::Layers parallax;
+		Parallax::Reset(parallax);
+
+		const double frameTime = 1.0 / config.fps;
+		const size_t tickCount = replay.inputs.size();
+		const int frameCount = static_cast<int>(std::ceil(static_cast<double>(tickCount) * replay.deltaT / frameTime)) + static_cast<int>(config.tail * config.fps) + 1;
+
+		// Two frames per encoder keeps them busy while the writer drains the oldest
+		Pipeline pipeline;
+		pipeline.slots.resize(static_cast<size_t>(config.encoderCount) * 2 + 1);
+
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < config.encoderCount; i++)
+		{
+			threads.emplace_back(Encode, std::cref(config), std::ref(pipeline));
+		}
+
+		threads.emplace_back(Write, std::cref(config), std::ref(pipeline));
+
+		SoftRender::Frame frame;
+		size_t tick = 0;
+		bool isMatching = true;
+
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < frameCount; i++)
+		{
+			// Frame i shows the last tick at or before its time
+			size_t targetTick = std::min(tickCount, static_cast<size_t>(i * frameTime / replay.deltaT + 1e-9));
+
+			while (tick < targetTick)
+			{
+				Replay::ApplyTuning(replay, tick);
+				step(world, replay.inputs[tick++]);
+
+				if (tick == tickCount && replay.finalHash != 0 && StateHash::Hash(world) != replay.finalHash)
+				{
+					isMatching = false;
+				}
+			}
+
+			if (i > 0 && !world.hasLost)
+			{
+				Parallax::Update(parallax, static_cast<float>(frameTime));
+			}
+
+			Slot& slot = pipeline.slots[i % pipeline.slots.size()];
+
+			{
+				std::unique_lock<std::mutex> lock(pipeline.mutex);
+				pipeline.changed.wait(lock, [&]() { return slot.state == SlotState::Free || pipeline.hasFailed; });
+
+				if (pipeline.hasFailed)
+				{
+					break;
+				}
+			}
+
+			// A free slot belongs to this thread until it is queued
+			Headless::RecordFrame(frame, world, parallax, config.width, config.height);
+			SoftRender::Render(frame, slot.framebuffer, config.tileSize);
+
+			std::lock_guard<std::mutex> lock(pipeline.mutex);
+			slot.frame = i;
+			slot.state = SlotState::Rendered;
+			pipeline.queue.push_back(static_cast<int>(i % pipeline.slots.size()));
+			pipeline.changed.notify_all();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(pipeline.mutex);
+			pipeline.isDone = true;
+			pipeline.frameCount = frameCount;
+			pipeline.changed.notify_all();
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		Parallax::Unload();
+		Jobs::Shutdown();
+
+		if (pipeline.hasFailed)
+		{
+			return 1;
+		}
+
+		double length = frameCount * frameTime;
+
+		std::cout << frameCount << " frames (" << length << " s of video) at " << config.width << "x" << config.height << " in " << seconds << " s: "
+			<< frameCount / seconds << " fps, " << length / seconds << "x real time\n";
+
+		if (!isMatching)
+		{
+			std::cerr << "the replay ended in a different state than it was recorded with, the game has changed since\n";
+			return 1;
+		}
+
+		return 0;
+	}
+}
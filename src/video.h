@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+
+#include "soft_render.h"
+
+namespace Video
+{
+	enum class Format
+	{
+		Y4m, Png
+	};
+
+	struct Config
+	{
+		std::string replayPath;
+
+		// The .y4m file, or for PNG the start of every frame's name: <output>00000.png, <output>00001.png...
+		std::string outputPath = "replay.y4m";
+		Format format = Format::Y4m;
+
+		// Y4M stores chroma at half resolution, so it needs both even
+		int width = 1250;
+		int height = 768;
+		int fps = 60;
+
+		// Seconds kept rolling after the round is lost
+		float tail = 1.0f;
+
+		int threadCount = 0;
+		int encoderCount = 2;
+		bool pinThreads = false;
+		int tileSize = SoftRender::defaultTileSize;
+	};
+
+	// Plays a replay back and renders every frame on the CPU. The main thread simulates and rasterizes on the job system
+	// while encoder threads convert finished frames and a writer thread stores them in order
+	int Run(const Config& config);
+}
@@ -0,0 +1,210 @@
+#include "world.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "globals.h"
+
+namespace World
+{
+	static_assert(std::is_trivially_copyable<World>::value, "World must stay plain data");
+	static_assert(maxPlayers <= 8, "Input has one bit per player");
+
+	namespace Variables
+	{
+		// Obstacles are red, so no bird is
+		const Color colors[maxPlayers] = { BLUE, GREEN, ORANGE, PURPLE, YELLOW, PINK, SKYBLUE, BROWN };
+	}
+
+	void Reset(World& world, int playerCount, uint64_t seed)
+	{
+		world = World();
+
+		world.playerCount = std::max(1, std::min(playerCount, maxPlayers));
+		world.playstyle = world.playerCount > 1 ? Playstyle::Multiplayer : Playstyle::Singleplayer;
+
+		float startX = static_cast<float>(Externs::screenWidth) / 6.0f;
+		float spacing = static_cast<float>(Externs::screenWidth) / 5.0f - startX;
+
+		for (int i = 0; i < world.playerCount; i++)
+		{
+			Player::Initialization(world.birds[i], { startX + spacing * i, static_cast<float>(Externs::screenHeight) / 2.0f });
+		}
+
+		world.seed = seed;
+		Rng::Seed(world.rng, seed);
+		Difficulty::Reset(world.difficulty);
+		// The last bird in line is the first to reach the obstacle
+		Vector2 firstToReach = world.birds[world.playerCount - 1].position;
+		Obstacle::Initialization(world.obstacle, world.rng, world.difficulty.levels, firstToReach);
+
+		world.deltaT = defaultDeltaT;
+	}
+
+	// starts are where the birds were before the step, obstacleStartX where the obstacle was
+	template <int playerCount>
+	static void CheckCollisionsFor(World& world, const Vector2* starts, float obstacleStartX);
+	template <int playerCount>
+	static void CheckCollisionsAt(World& world);
+
+	// Indexed by player count - 1
+	static const StepFunction steps[maxPlayers] = { Step<1>, Step<2>, Step<3>, Step<4>, Step<5>, Step<6>, Step<7>, Step<8> };
+	static void (* const collisionChecks[maxPlayers])(World& world) = { CheckCollisionsAt<1>, CheckCollisionsAt<2>, CheckCollisionsAt<3>, CheckCollisionsAt<4>, CheckCollisionsAt<5>, CheckCollisionsAt<6>, CheckCollisionsAt<7>, CheckCollisionsAt<8> };
+
+	void Update(World& world, Input input)
+	{
+		steps[world.playerCount - 1](world, input);
+	}
+
+	template <int playerCount>
+	void Step(World& world, Input input)
+	{
+		static_assert(playerCount >= 1 && playerCount <= maxPlayers, "No such player count");
+
+		world.events = 0;
+		world.hits = 0;
+
+		if (world.hasLost)
+		{
+			return;
+		}
+
+		world.tick++;
+		world.timeAlive += world.deltaT;
+
+		Obstacle::Obstacle& obstacle = world.obstacle;
+
+		Vector2 starts[playerCount];
+
+		for (int i = 0; i < playerCount; i++)
+		{
+			Player::Bird& bird = world.birds[i];
+
+			starts[i] = bird.position;
+
+			if (!bird.isOn)
+			{
+				continue;
+			}
+
+			uint8_t bit = static_cast<uint8_t>(1 << i);
+
+			if (!(obstacle.passed & bit) && obstacle.bottom.x < bird.position.x)
+			{
+				world.scores[i] += 1;
+				world.score = std::max(world.score, world.scores[i]);
+				obstacle.passed |= bit;
+			}
+
+			bool isMoving = (input & bit) != 0;
+
+			Player::Move(bird, isMoving, world.deltaT);
+
+			if (isMoving)
+			{
+				world.events |= Events::flap;
+			}
+
+			if (!bird.isOn)
+			{
+				world.events |= Events::fall;
+			}
+		}
+
+		Difficulty::Advance(world.difficulty, world.score, world.timeAlive);
+		obstacle.velocity = world.difficulty.levels.obstacleVelocity;
+
+		float obstacleStartX = obstacle.bottom.x;
+
+		Obstacle::Move(obstacle, world.rng, world.deltaT, world.difficulty.levels);
+
+		// A respawned obstacle did not sweep across the screen, it only counts where it is now
+		if (obstacle.bottom.x > obstacleStartX)
+		{
+			obstacleStartX = obstacle.bottom.x;
+		}
+
+		CheckCollisionsFor<playerCount>(world, starts, obstacleStartX);
+	}
+
+	template void Step<1>(World& world, Input input);
+	template void Step<2>(World& world, Input input);
+	template void Step<3>(World& world, Input input);
+	template void Step<4>(World& world, Input input);
+	template void Step<5>(World& world, Input input);
+	template void Step<6>(World& world, Input input);
+	template void Step<7>(World& world, Input input);
+	template void Step<8>(World& world, Input input);
+
+	StepFunction GetStep(int playerCount)
+	{
+		return steps[std::max(1, std::min(playerCount, maxPlayers)) - 1];
+	}
+
+	void CheckCollisions(World& world)
+	{
+		collisionChecks[world.playerCount - 1](world);
+	}
+
+	template <int playerCount>
+	void CheckCollisionsAt(World& world)
+	{
+		// Without a step to sweep over, the birds and the obstacle stand still
+		Vector2 starts[playerCount];
+
+		for (int i = 0; i < playerCount; i++)
+		{
+			starts[i] = world.birds[i].position;
+		}
+
+		CheckCollisionsFor<playerCount>(world, starts, world.obstacle.bottom.x);
+	}
+
+	template <int playerCount>
+	void CheckCollisionsFor(World& world, const Vector2* starts, float obstacleStartX)
+	{
+		bool isAnyoneOn = false;
+
+		for (int i = 0; i < playerCount; i++)
+		{
+			Player::Bird& bird = world.birds[i];
+
+			// Swept rather than tested where the step ended, so a long step can't carry a bird through the obstacle
+			if (bird.isOn && Obstacle::GetImpactTime(world.obstacle, obstacleStartX, starts[i], bird.position) <= 1.0f)
+			{
+				bird.isOn = false;
+				world.hits |= static_cast<uint8_t>(1 << i);
+				world.events |= Events::hit;
+			}
+
+			isAnyoneOn = isAnyoneOn || bird.isOn;
+		}
+
+		if (!isAnyoneOn)
+		{
+			world.hasLost = true;
+		}
+	}
+
+	void Draw(const World& world)
+	{
+		for (int i = 0; i < world.playerCount; i++)
+		{
+			Player::Draw(world.birds[i], Variables::colors[i]);
+		}
+
+		Obstacle::Draw(world.obstacle);
+	}
+
+	Observation Observe(Player::Bird bird, Obstacle::Obstacle obstacle)
+	{
+		Observation observation;
+
+		observation.birdY = bird.position.y;
+		observation.birdVelocity = bird.velocity;
+		observation.gapY = (obstacle.bottom.y + obstacle.height + obstacle.top.y) / 2.0f;
+		observation.gapDistance = obstacle.bottom.x + obstacle.width - bird.position.x;
+
+		return observation;
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+
+#include "difficulty.h"
+#include "player.h"
+#include "obstacle.h"
+#include "rng.h"
+
+namespace World
+{
+	enum class Playstyle
+	{
+		Singleplayer, Multiplayer
+	};
+
+	// Bit i set means player i flaps this tick, so one byte covers every player
+	typedef uint8_t Input;
+
+	const int maxPlayers = 8;
+
+	namespace Events
+	{
+		const unsigned int flap = 1 << 0;
+		const unsigned int hit = 1 << 1;
+		const unsigned int fall = 1 << 2;
+	}
+
+	const float defaultDeltaT = 1.0f / 120.0f;
+
+	// Everything a game needs to advance; plain data so it can be copied, snapshotted and stepped on any thread
+	struct World
+	{
+		Player::Bird birds[maxPlayers];
+		int scores[maxPlayers];
+		int playerCount;
+
+		Obstacle::Obstacle obstacle;
+		Difficulty::State difficulty;
+
+		Rng::Rng rng;
+		uint64_t seed;
+
+		Playstyle playstyle;
+
+		// Best of the players' scores
+		int score;
+		float timeAlive;
+
+		float deltaT;
+		uint64_t tick;
+
+		bool hasLost;
+		bool retry;
+
+		// Events raised by the last Update, for sounds and other presentation
+		unsigned int events;
+
+		// Bit i is set when player i hit the obstacle in the last Update
+		uint8_t hits;
+	};
+
+	struct Observation
+	{
+		float birdY;
+		float birdVelocity;
+		float gapY;
+		float gapDistance;
+	};
+
+	void Reset(World& world, int playerCount, uint64_t seed);
+	// Runs the step specialized for world.playerCount; hot loops should pick it once with GetStep instead
+	void Update(World& world, Input input);
+
+	// Update compiled for a fixed number of players, so the per-player loops unroll and nothing reads the count per tick.
+	// Only valid on a world reset with that many players
+	template <int playerCount>
+	void Step(World& world, Input input);
+
+	typedef void (*StepFunction)(World& world, Input input);
+
+	StepFunction GetStep(int playerCount);
+	void CheckCollisions(World& world);
+	void Draw(const World& world);
+
+	Observation Observe(Player::Bird bird, Obstacle::Obstacle obstacle);
+}